@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file OpenSetAnalysis.cpp
+ *
+ * @brief Exact probabilities of set-free boards.
+ *
+ * Enumerates all set-free boards up to symmetry (see CapEnumerator.hpp) and
+ * reports, for every board size, the number of classes, the exact number of
+ * set-free boards, and the probability that a random board of that size does
+ * not contain a set. For the classic 12 card board, this probability is
+ * 2284535476080 / 70724320184700, or about 1 in 31.
+ *
+ * Usage: openset_analysis [MAXIMUM BOARD SIZE] [NUMBER OF THREADS]
+ *                         [CHECKPOINT FILE]
+ *
+ * Progress is written to the checkpoint file (default:
+ * openset_analysis.checkpoint), and a run that finds an existing checkpoint
+ * resumes from it.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "analysis/CapEnumerator.hpp"
+#include "parallel/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Main analysis program.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  unsigned char maximum_size = AffineSpace::MAXIMUM_CAP_SIZE;
+  if (argc > 1) {
+    maximum_size = std::min<unsigned long>(strtoul(argv[1], NULL, 10),
+                                           AffineSpace::MAXIMUM_CAP_SIZE);
+  }
+  // 0 means: one thread per core
+  unsigned int number_of_threads = 0;
+  if (argc > 2) {
+    number_of_threads = strtoul(argv[2], NULL, 10);
+  }
+  std::string checkpoint_filename = "openset_analysis.checkpoint";
+  if (argc > 3) {
+    checkpoint_filename = argv[3];
+  }
+
+  WorkStealingPool pool(number_of_threads);
+  number_of_threads = pool.get_number_of_workers();
+
+  CapEnumerator enumerator(pool, checkpoint_filename);
+  if (enumerator.load_checkpoint()) {
+    std::cout << "Resuming from " << checkpoint_filename << " (size "
+              << static_cast<unsigned int>(enumerator.get_size()) << ")."
+              << std::endl;
+  }
+
+  std::cout << "Enumerating set-free boards with up to "
+            << static_cast<unsigned int>(maximum_size) << " cards on "
+            << number_of_threads << " threads..." << std::endl;
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  pool.reset_statistics();
+  const bool checkpoints_written = enumerator.run(maximum_size);
+  std::chrono::duration<double> time =
+      std::chrono::steady_clock::now() - start;
+  if (!checkpoints_written) {
+    std::cerr << "Warning: could not write checkpoint " << checkpoint_filename
+              << "!" << std::endl;
+  }
+
+  std::cout << "size\tclasses\tset-free boards\tboards\tprobability\n";
+  const unsigned char size = std::min(maximum_size, enumerator.get_size());
+  for (unsigned char i = 0; i <= size; ++i) {
+    std::cout << static_cast<unsigned int>(i) << "\t"
+              << enumerator.get_number_of_classes(i) << "\t"
+              << enumerator.get_number_of_caps(i) << "\t"
+              << CapEnumerator::get_number_of_boards(i) << "\t"
+              << enumerator.get_probability(i) << "\n";
+  }
+  std::cout << "worker statistics (tasks, steals, failed steals, "
+               "utilization):\n";
+  for (unsigned int i = 0; i < number_of_threads; ++i) {
+    std::cout << i << "\t" << pool.get_number_of_tasks(i) << "\t"
+              << pool.get_number_of_steals(i) << "\t"
+              << pool.get_number_of_failed_steals(i) << "\t"
+              << pool.get_utilization(i) << "\n";
+  }
+  std::cout << "time: " << time.count() << " s" << std::endl;
+
+  return 0;
+}
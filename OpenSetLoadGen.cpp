@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file OpenSetLoadGen.cpp
+ *
+ * @brief Load generator for the game server.
+ *
+ * Opens a number of connections to a running openset_server. Every connection
+ * behaves like a player that keeps claiming sets in one game: it sends a
+ * single request, waits for the reply, and immediately sends the next request
+ * based on the board in the reply. Connection i plays game i % NUMBER OF
+ * GAMES, so that several connections race for the same sets if there are more
+ * connections than games. Finished games are dealt again.
+ *
+ * Usage: openset_loadgen [ADDRESS] [NUMBER OF CONNECTIONS] [NUMBER OF GAMES]
+ *                        [DURATION (s)]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "engine/CardManager.hpp"
+#include "network/GameProtocol.hpp"
+#include "network/Socket.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief Simulated player on a single connection.
+ */
+struct LoadGenConnection {
+  /*! @brief Socket. */
+  int _socket;
+
+  /*! @brief Index of the game the player plays. */
+  uint32_t _game;
+
+  /*! @brief Bytes of the reply that were received so far. */
+  unsigned char _reply[sizeof(GameReply)];
+
+  /*! @brief Number of bytes of the reply that were received so far. */
+  size_t _reply_size;
+
+  /*! @brief Time the outstanding request was sent. */
+  std::chrono::steady_clock::time_point _request_time;
+};
+
+/**
+ * @brief Send a request on the given connection.
+ *
+ * Every connection has at most one outstanding request, so the request always
+ * fits in the send buffer of the socket.
+ *
+ * @param connection Connection.
+ * @param request GameRequest to send.
+ * @return True on success.
+ */
+static bool send_request(LoadGenConnection &connection,
+                         const GameRequest &request) {
+  connection._request_time = std::chrono::steady_clock::now();
+  return write(connection._socket, &request, sizeof(request)) ==
+         sizeof(request);
+}
+
+/**
+ * @brief Main load generator program.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  std::string address = "/tmp/openset.sock";
+  if (argc > 1) {
+    address = argv[1];
+  }
+  unsigned int number_of_connections = 100;
+  if (argc > 2) {
+    number_of_connections = strtoul(argv[2], NULL, 10);
+  }
+  uint32_t number_of_games = 50;
+  if (argc > 3) {
+    number_of_games = strtoul(argv[3], NULL, 10);
+  }
+  double duration = 5.;
+  if (argc > 4) {
+    duration = strtod(argv[4], NULL);
+  }
+  if (number_of_connections == 0 || number_of_games == 0) {
+    std::cerr << "Need at least one connection and one game!" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Playing " << number_of_games << " games on "
+            << number_of_connections << " connections to " << address
+            << " for " << duration << " s..." << std::endl;
+
+  const int epoll = epoll_create1(0);
+  std::vector<LoadGenConnection> connections(number_of_connections);
+  for (unsigned int i = 0; i < number_of_connections; ++i) {
+    LoadGenConnection &connection = connections[i];
+    connection._socket = Socket::connect(address);
+    if (connection._socket < 0) {
+      std::cerr << "Could not connect to " << address << "!" << std::endl;
+      return 1;
+    }
+    connection._game = i % number_of_games;
+    connection._reply_size = 0;
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = i;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, connection._socket, &event);
+
+    GameRequest request;
+    std::memset(&request, 0, sizeof(request));
+    request._type = GAMEREQUEST_BOARD;
+    request._game = connection._game;
+    send_request(connection, request);
+  }
+
+  // latencies of all claims (in ns)
+  std::vector<uint32_t> latencies;
+  latencies.reserve(1 << 20);
+  unsigned long replies[GAMEREPLY_COUNTER] = {0};
+  uint64_t next_seed = 1;
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const std::chrono::steady_clock::time_point end =
+      start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(duration));
+  epoll_event events[256];
+  std::chrono::steady_clock::time_point now = start;
+  while (now < end) {
+    const int number_of_events = epoll_wait(epoll, events, 256, 100);
+    now = std::chrono::steady_clock::now();
+    for (int i = 0; i < number_of_events; ++i) {
+      LoadGenConnection &connection = connections[events[i].data.u32];
+      const ssize_t size =
+          recv(connection._socket, connection._reply + connection._reply_size,
+               sizeof(GameReply) - connection._reply_size, MSG_DONTWAIT);
+      if (size <= 0) {
+        std::cerr << "Connection closed by the server!" << std::endl;
+        return 1;
+      }
+      connection._reply_size += size;
+      if (connection._reply_size < sizeof(GameReply)) {
+        continue;
+      }
+      connection._reply_size = 0;
+
+      GameReply reply;
+      std::memcpy(&reply, connection._reply, sizeof(reply));
+      if (reply._result >= GAMEREPLY_COUNTER ||
+          reply._result == GAMEREPLY_ERROR) {
+        std::cerr << "Malformed request!" << std::endl;
+        return 1;
+      }
+      ++replies[reply._result];
+      if (reply._type == GAMEREQUEST_CLAIM) {
+        const std::chrono::nanoseconds latency =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now - connection._request_time);
+        latencies.push_back(latency.count());
+      }
+
+      // claim a set on the new board, or deal a new game if there is none
+      GameRequest request;
+      std::memset(&request, 0, sizeof(request));
+      request._game = connection._game;
+      const unsigned char number_of_sets = CardManager::find_all_sets(
+          reply._main_deck, reply._main_deck_size, sets);
+      if (number_of_sets > 0) {
+        const unsigned char *set =
+            sets + 3 * (events[i].data.u32 % number_of_sets);
+        request._type = GAMEREQUEST_CLAIM;
+        request._positions[0] = set[0];
+        request._positions[1] = set[1];
+        request._positions[2] = set[2];
+        request._argument = reply._version;
+      } else {
+        request._type = GAMEREQUEST_DEAL;
+        request._argument = next_seed++;
+      }
+      if (!send_request(connection, request)) {
+        std::cerr << "Could not send request!" << std::endl;
+        return 1;
+      }
+    }
+  }
+  const std::chrono::duration<double> time = now - start;
+
+  for (unsigned int i = 0; i < number_of_connections; ++i) {
+    close(connections[i]._socket);
+  }
+  close(epoll);
+
+  std::sort(latencies.begin(), latencies.end());
+  const unsigned long number_of_claims = latencies.size();
+  std::cout << "claims: " << number_of_claims << "\n";
+  std::cout << "claims won: " << replies[GAMEREPLY_WON] << "\n";
+  std::cout << "stale claims: " << replies[GAMEREPLY_STALE] << "\n";
+  std::cout << "invalid claims: " << replies[GAMEREPLY_INVALID] << "\n";
+  std::cout << "claims/sec: " << number_of_claims / time.count() << "\n";
+  std::cout << "sets taken/sec: " << replies[GAMEREPLY_WON] / time.count()
+            << "\n";
+  if (number_of_claims > 0) {
+    std::cout << "claim latency p50: "
+              << 1.e-3 * latencies[number_of_claims / 2] << " us\n";
+    std::cout << "claim latency p99: "
+              << 1.e-3 * latencies[(99 * number_of_claims) / 100] << " us\n";
+    std::cout << "claim latency max: " << 1.e-3 * latencies.back() << " us\n";
+  }
+  std::cout << "time: " << time.count() << " s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file OpenSetServer.cpp
+ *
+ * @brief Headless game server.
+ *
+ * Hosts a number of games that clients can play using the binary protocol in
+ * network/GameProtocol.hpp, until the server is interrupted (Ctrl+C).
+ *
+ * Usage: openset_server [ADDRESS] [NUMBER OF GAMES] [SEED]
+ *
+ * ADDRESS is either the path of a Unix-domain socket, or a TCP port on the
+ * loopback interface. Game i is initially dealt using seed SEED + i.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "network/GameServer.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+
+/*! @brief Server that is stopped when the program is interrupted. */
+static GameServer *global_server = NULL;
+
+/**
+ * @brief Signal handler that stops the server.
+ *
+ * The signal number is not used.
+ */
+static void stop_server(int) {
+  if (global_server != NULL) {
+    global_server->stop();
+  }
+}
+
+/**
+ * @brief Main server program.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  std::string address = "/tmp/openset.sock";
+  if (argc > 1) {
+    address = argv[1];
+  }
+  uint32_t number_of_games = 1000;
+  if (argc > 2) {
+    number_of_games = strtoul(argv[2], NULL, 10);
+  }
+  uint64_t seed = 42;
+  if (argc > 3) {
+    seed = strtoull(argv[3], NULL, 10);
+  }
+
+  GameServer server(address, number_of_games, seed);
+  if (!server.is_listening()) {
+    std::cerr << "Could not listen on " << address << "!" << std::endl;
+    return 1;
+  }
+  global_server = &server;
+  std::signal(SIGINT, stop_server);
+  std::signal(SIGTERM, stop_server);
+  // clients that disappear should not kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+
+  std::cout << "Hosting " << number_of_games << " games on " << address
+            << " (seed: " << seed << ")..." << std::endl;
+  server.run();
+  global_server = NULL;
+
+  std::cout << "board requests: "
+            << server.get_number_of_requests(GAMEREQUEST_BOARD) << "\n";
+  std::cout << "claim requests: "
+            << server.get_number_of_requests(GAMEREQUEST_CLAIM) << "\n";
+  std::cout << "deal requests: "
+            << server.get_number_of_requests(GAMEREQUEST_DEAL) << "\n";
+  std::cout << "claims won: " << server.get_number_of_replies(GAMEREPLY_WON)
+            << "\n";
+  std::cout << "stale claims: "
+            << server.get_number_of_replies(GAMEREPLY_STALE) << "\n";
+  std::cout << "invalid claims: "
+            << server.get_number_of_replies(GAMEREPLY_INVALID) << "\n";
+  std::cout << "malformed requests: "
+            << server.get_number_of_replies(GAMEREPLY_ERROR) << std::endl;
+
+  return 0;
+}
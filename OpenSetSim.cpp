@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file OpenSetSim.cpp
+ *
+ * @brief Headless Monte Carlo game simulator.
+ *
+ * Plays complete games with automatic set selection on a number of worker
+ * threads and reports statistics about the boards that were encountered.
+ * Games are distributed over the threads by a work-stealing pool, so that
+ * threads that happen to get short games do not sit idle.
+ *
+ * Usage: openset_sim [NUMBER OF GAMES] [NUMBER OF THREADS] [SEED]
+ *
+ * Game i is dealt using seed SEED + i, so that the results do not depend on
+ * the number of threads, and can be reproduced by using the same seed.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "engine/CardManager.hpp"
+#include "parallel/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/*! @brief Maximum number of sets that can be taken during a single game. */
+#define SIMULATION_MAX_GAME_LENGTH (CardIndex::CARDINDEX_COUNTER / 3)
+
+/**
+ * @brief Counters and histograms gathered by a single worker thread.
+ */
+class SimulationStatistics {
+private:
+  /*! @brief Number of games that was played. */
+  unsigned long _number_of_games;
+
+  /*! @brief Number of games that ended with cards left on the card stack:
+   *  the main deck reached its maximum size without containing a set. */
+  unsigned long _number_of_stalled_games;
+
+  /*! @brief Number of times extra cards were dealt because the main deck did
+   *  not contain a set. */
+  unsigned long _number_of_extra_deals;
+
+  /*! @brief Histogram of the number of sets on every board that was
+   *  encountered, excluding the final board of every game. */
+  unsigned long _sets_per_board[CardManager::MAX_NUMBER_OF_SETS + 1];
+
+  /*! @brief Histogram of the size of every board that was encountered,
+   *  excluding the final board of every game. */
+  unsigned long _board_size[CardManager::MAX_BOARD_SIZE + 1];
+
+  /*! @brief Histogram of the number of sets that was taken per game. */
+  unsigned long _game_length[SIMULATION_MAX_GAME_LENGTH + 1];
+
+  /**
+   * @brief Add the boards without a set that were expanded since the given
+   * state.
+   *
+   * The CardManager deals extra cards as soon as the main deck does not
+   * contain a set, so these boards are never seen by the simulator. We
+   * reconstruct them from the number of cards that was dealt: every group of
+   * 3 cards on top of the cards that replaced the taken set is an extra deal.
+   *
+   * @param state State before the move (or before the initial deal).
+   * @param replaced_cards Number of cards that replaced the taken set.
+   * @param card_manager CardManager after the move.
+   */
+  void add_extra_deals(const GameState &state, unsigned char replaced_cards,
+                       const CardManager &card_manager) {
+    const GameState &new_state = card_manager.get_state();
+    const unsigned char extra_cards =
+        new_state._next_card - state._next_card - replaced_cards;
+    const unsigned char extra_deals = (extra_cards + 2) / 3;
+    _number_of_extra_deals += extra_deals;
+    for (unsigned char i = 0; i < extra_deals; ++i) {
+      ++_sets_per_board[0];
+      ++_board_size[new_state._main_deck_size - extra_cards + 3 * i];
+    }
+  }
+
+public:
+  /**
+   * @brief Empty constructor.
+   */
+  SimulationStatistics()
+      : _number_of_games(0), _number_of_stalled_games(0),
+        _number_of_extra_deals(0), _sets_per_board{}, _board_size{},
+        _game_length{} {}
+
+  /**
+   * @brief Play a single game and add its statistics.
+   *
+   * We always take the first set that is found on the board, and continue
+   * until the board contains no more sets. Boards without a set are expanded
+   * by the CardManager; we count these as boards without a set, so that the
+   * board histograms contain every board a player would see. The final board
+   * of a game is not counted, since it never contains a set.
+   *
+   * @param seed Seed used to deal the game.
+   */
+  void play_game(uint64_t seed) {
+    CardManager card_manager(seed);
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    unsigned char game_length = 0;
+    // the initial deal consists of BASE_BOARD_SIZE cards
+    GameState state = GameState();
+    add_extra_deals(state, CardManager::BASE_BOARD_SIZE, card_manager);
+    unsigned char number_of_sets = card_manager.find_all_sets(sets);
+    while (number_of_sets > 0) {
+      ++_sets_per_board[number_of_sets];
+      ++_board_size[card_manager.get_board().size()];
+      state = card_manager.get_state();
+      card_manager.click_card(sets[0]);
+      card_manager.click_card(sets[1]);
+      card_manager.click_card(sets[2]);
+      ++game_length;
+      // the set is only replaced if the main deck was not expanded
+      unsigned char replaced_cards = 0;
+      if (state._main_deck_size <= CardManager::BASE_BOARD_SIZE) {
+        replaced_cards =
+            std::min(3, CardIndex::CARDINDEX_COUNTER - state._next_card);
+      }
+      add_extra_deals(state, replaced_cards, card_manager);
+      number_of_sets = card_manager.find_all_sets(sets);
+    }
+
+    ++_number_of_games;
+    ++_game_length[game_length];
+    const unsigned char cards_left = CardIndex::CARDINDEX_COUNTER -
+                                     3 * game_length -
+                                     card_manager.get_board().size();
+    if (cards_left > 0) {
+      ++_number_of_stalled_games;
+    }
+  }
+
+  /**
+   * @brief Add the statistics of the given instance to this instance.
+   *
+   * @param statistics Other SimulationStatistics instance.
+   */
+  void merge(const SimulationStatistics &statistics) {
+    _number_of_games += statistics._number_of_games;
+    _number_of_stalled_games += statistics._number_of_stalled_games;
+    _number_of_extra_deals += statistics._number_of_extra_deals;
+    for (unsigned char i = 0; i < CardManager::MAX_NUMBER_OF_SETS + 1; ++i) {
+      _sets_per_board[i] += statistics._sets_per_board[i];
+    }
+    for (unsigned char i = 0; i < CardManager::MAX_BOARD_SIZE + 1; ++i) {
+      _board_size[i] += statistics._board_size[i];
+    }
+    for (unsigned char i = 0; i < SIMULATION_MAX_GAME_LENGTH + 1; ++i) {
+      _game_length[i] += statistics._game_length[i];
+    }
+  }
+
+  /**
+   * @brief Print the statistics to the given stream.
+   *
+   * @param stream std::ostream to write to.
+   */
+  void print(std::ostream &stream) const {
+    unsigned long number_of_boards = 0;
+    unsigned long number_of_board_sets = 0;
+    for (unsigned char i = 0; i < CardManager::MAX_NUMBER_OF_SETS + 1; ++i) {
+      number_of_boards += _sets_per_board[i];
+      number_of_board_sets += i * _sets_per_board[i];
+    }
+    unsigned long number_of_sets_taken = 0;
+    for (unsigned char i = 0; i < SIMULATION_MAX_GAME_LENGTH + 1; ++i) {
+      number_of_sets_taken += i * _game_length[i];
+    }
+
+    stream << "games: " << _number_of_games << "\n";
+    stream << "stalled games: " << _number_of_stalled_games << "\n";
+    stream << "extra deals: " << _number_of_extra_deals << "\n";
+    stream << "extra deals per game: "
+           << double(_number_of_extra_deals) / _number_of_games << "\n";
+    stream << "boards: " << number_of_boards << "\n";
+    stream << "average sets per board: "
+           << double(number_of_board_sets) / number_of_boards << "\n";
+    stream << "fraction of boards without set: "
+           << double(_sets_per_board[0]) / number_of_boards << "\n";
+    stream << "average game length: "
+           << double(number_of_sets_taken) / _number_of_games << "\n";
+    stream << "sets per board histogram:\n";
+    for (unsigned char i = 0; i < CardManager::MAX_NUMBER_OF_SETS + 1; ++i) {
+      if (_sets_per_board[i] > 0) {
+        stream << static_cast<unsigned int>(i) << "\t" << _sets_per_board[i]
+               << "\n";
+      }
+    }
+    stream << "board size histogram:\n";
+    for (unsigned char i = 0; i < CardManager::MAX_BOARD_SIZE + 1; ++i) {
+      if (_board_size[i] > 0) {
+        stream << static_cast<unsigned int>(i) << "\t" << _board_size[i]
+               << "\n";
+      }
+    }
+    stream << "game length histogram:\n";
+    for (unsigned char i = 0; i < SIMULATION_MAX_GAME_LENGTH + 1; ++i) {
+      if (_game_length[i] > 0) {
+        stream << static_cast<unsigned int>(i) << "\t" << _game_length[i]
+               << "\n";
+      }
+    }
+  }
+};
+
+/**
+ * @brief Main simulator program.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  unsigned long number_of_games = 100000;
+  if (argc > 1) {
+    number_of_games = strtoul(argv[1], NULL, 10);
+  }
+  // 0 means: one thread per core
+  unsigned int number_of_threads = 0;
+  if (argc > 2) {
+    number_of_threads = strtoul(argv[2], NULL, 10);
+  }
+  uint64_t seed = 42;
+  if (argc > 3) {
+    seed = strtoull(argv[3], NULL, 10);
+  }
+
+  WorkStealingPool pool(number_of_threads, seed);
+  number_of_threads = pool.get_number_of_workers();
+
+  std::cout << "Playing " << number_of_games << " games on "
+            << number_of_threads << " threads (seed: " << seed << ")..."
+            << std::endl;
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  // every thread gets its own statistics; games are queued in chunks of
+  // consecutive seeds
+  std::vector<SimulationStatistics> statistics(number_of_threads);
+  pool.reset_statistics();
+  pool.run_batch(number_of_games,
+                 [&statistics, seed](unsigned long game, unsigned int worker) {
+                   statistics[worker].play_game(seed + game);
+                 });
+
+  SimulationStatistics total_statistics;
+  for (unsigned int i = 0; i < number_of_threads; ++i) {
+    total_statistics.merge(statistics[i]);
+  }
+
+  std::chrono::duration<double> time =
+      std::chrono::steady_clock::now() - start;
+
+  total_statistics.print(std::cout);
+  std::cout << "worker statistics (tasks, steals, failed steals, "
+               "utilization):\n";
+  for (unsigned int i = 0; i < number_of_threads; ++i) {
+    std::cout << i << "\t" << pool.get_number_of_tasks(i) << "\t"
+              << pool.get_number_of_steals(i) << "\t"
+              << pool.get_number_of_failed_steals(i) << "\t"
+              << pool.get_utilization(i) << "\n";
+  }
+  std::cout << "time: " << time.count() << " s\n";
+  std::cout << "games/sec: " << number_of_games / time.count() << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,403 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file AffineSpace.cpp
+ *
+ * @brief The cards of the game as points of the affine space AG(4,3):
+ * implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "AffineSpace.hpp"
+#include "../engine/Card.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+/*! @brief Value used to mark points that are not (yet) part of a flat. */
+#define AFFINESPACE_NO_LABEL 0xff
+
+/**
+ * @brief Search for the canonical form of a set of points.
+ *
+ * Every ordered affine basis (b_0, ..., b_d) of the flat spanned by the points
+ * defines a unique affine map that sends b_0 to the origin and b_i to the i-th
+ * unit vector. The canonical form is the smallest image of the points under
+ * any of these maps. Two sets of points are equivalent if and only if they
+ * have the same canonical form.
+ *
+ * Trying all bases is too expensive, so we only try bases that are optimal
+ * according to invariants that are preserved by affine maps: for every point
+ * c outside the set, we count the number of lines through c that contain two
+ * points of the set, and for every point of the set, we count how often these
+ * counts occur for the third points on the lines through that point. Since
+ * the admissible bases are defined in terms of invariants, an automorphism of
+ * the set maps admissible bases onto admissible bases, and the number of
+ * admissible bases that produce the canonical form is exactly the number of
+ * affine maps of the flat that map the set onto itself.
+ */
+class CanonicalFormSearch {
+private:
+  /*! @brief Space. */
+  const AffineSpace &_space;
+
+  /*! @brief Points in the set. */
+  unsigned char _points[AffineSpace::NUMBER_OF_POINTS];
+
+  /*! @brief Number of points in the set. */
+  unsigned char _number_of_points;
+
+  /*! @brief Dimension of the flat spanned by the points. */
+  unsigned char _dimension;
+
+  /*! @brief Number of lines through every point that contain two points of
+   *  the set. */
+  unsigned char _cover[AffineSpace::NUMBER_OF_POINTS];
+
+  /*! @brief Invariant of every point in the set. */
+  uint64_t _invariant[AffineSpace::NUMBER_OF_POINTS];
+
+  /*! @brief Basis that is being constructed. */
+  unsigned char _basis[AffineSpace::DIMENSION + 1];
+
+  /*! @brief Smallest image found so far. */
+  CardMask _best;
+
+  /*! @brief Number of bases that produced the smallest image. */
+  uint64_t _number_of_best;
+
+  /**
+   * @brief Check if the first mask is smaller than the second mask.
+   *
+   * @param a First mask.
+   * @param b Second mask.
+   * @return True if a comes before b.
+   */
+  inline static bool is_smaller(const CardMask &a, const CardMask &b) {
+    return a.get_word(1) < b.get_word(1) ||
+           (a.get_word(1) == b.get_word(1) && a.get_word(0) < b.get_word(0));
+  }
+
+  /**
+   * @brief Get the key used to select the next basis point.
+   *
+   * @param point Candidate point.
+   * @param level Number of basis points that was already chosen.
+   * @return Key that combines the cover counts of the third points on the
+   * lines through the candidate and the basis points chosen so far.
+   */
+  inline uint32_t get_key(unsigned char point, unsigned char level) const {
+    uint32_t key = 0;
+    for (unsigned char i = 0; i < level; ++i) {
+      key = (key << 4) |
+            std::min<unsigned char>(_cover[_space.get_third(_basis[i], point)],
+                                    15);
+    }
+    return key;
+  }
+
+  /**
+   * @brief Extend the basis with one more point.
+   *
+   * @param level Number of basis points that was already chosen.
+   * @param labels Label of every point in the flat spanned by the basis
+   * points: the point with the coordinates of the point with respect to the
+   * basis (AFFINESPACE_NO_LABEL for points outside the flat).
+   * @param flat Points in the flat spanned by the basis points.
+   */
+  void extend(unsigned char level, const unsigned char *labels,
+              const unsigned char *flat) {
+
+    if (level == _dimension + 1) {
+      CardMask image;
+      for (unsigned char i = 0; i < _number_of_points; ++i) {
+        image.add(labels[_points[i]]);
+      }
+      if (_number_of_best == 0 || is_smaller(image, _best)) {
+        _best = image;
+        _number_of_best = 1;
+      } else if (image == _best) {
+        ++_number_of_best;
+      }
+      return;
+    }
+
+    // find the admissible candidates: points outside the flat with the
+    // smallest key and invariant
+    unsigned char candidates[AffineSpace::NUMBER_OF_POINTS];
+    unsigned char number_of_candidates = 0;
+    uint32_t best_key = 0;
+    uint64_t best_invariant = 0;
+    for (unsigned char i = 0; i < _number_of_points; ++i) {
+      const unsigned char point = _points[i];
+      if (level > 0 && labels[point] != AFFINESPACE_NO_LABEL) {
+        continue;
+      }
+      const uint32_t key = get_key(point, level);
+      const uint64_t invariant = _invariant[point];
+      if (number_of_candidates == 0 || key < best_key ||
+          (key == best_key && invariant < best_invariant)) {
+        best_key = key;
+        best_invariant = invariant;
+        number_of_candidates = 0;
+      } else if (key != best_key || invariant != best_invariant) {
+        continue;
+      }
+      candidates[number_of_candidates] = point;
+      ++number_of_candidates;
+    }
+
+    // the new basis vector gets coordinate 3^(DIMENSION - level) in the image
+    unsigned char weight = 1;
+    for (unsigned char i = level; i < AffineSpace::DIMENSION; ++i) {
+      weight *= 3;
+    }
+    const unsigned char flat_size = weight == 81 ? 0 : 81 / (3 * weight);
+
+    unsigned char new_labels[AffineSpace::NUMBER_OF_POINTS];
+    unsigned char new_flat[AffineSpace::NUMBER_OF_POINTS];
+    for (unsigned char c = 0; c < number_of_candidates; ++c) {
+      const unsigned char point = candidates[c];
+      _basis[level] = point;
+      if (level == 0) {
+        std::fill(new_labels, new_labels + AffineSpace::NUMBER_OF_POINTS,
+                  AFFINESPACE_NO_LABEL);
+        new_labels[point] = 0;
+        new_flat[0] = point;
+      } else {
+        std::copy(labels, labels + AffineSpace::NUMBER_OF_POINTS, new_labels);
+        const unsigned char vector =
+            _space.get_difference(point, _basis[0]);
+        const unsigned char vector2 = _space.get_sum(vector, vector);
+        for (unsigned char i = 0; i < flat_size; ++i) {
+          const unsigned char old_point = flat[i];
+          const unsigned char point1 = _space.get_sum(old_point, vector);
+          const unsigned char point2 = _space.get_sum(old_point, vector2);
+          new_flat[i] = old_point;
+          new_flat[flat_size + i] = point1;
+          new_flat[2 * flat_size + i] = point2;
+          new_labels[point1] = labels[old_point] + weight;
+          new_labels[point2] = labels[old_point] + 2 * weight;
+        }
+      }
+      extend(level + 1, new_labels, new_flat);
+    }
+  }
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param space Space.
+   * @param points Set of points.
+   */
+  CanonicalFormSearch(const AffineSpace &space, const CardMask &points)
+      : _space(space), _number_of_points(0), _cover{}, _invariant{},
+        _basis{}, _number_of_best(0) {
+
+    for (unsigned char point = 0; point < AffineSpace::NUMBER_OF_POINTS;
+         ++point) {
+      if (points.contains(point)) {
+        _points[_number_of_points] = point;
+        ++_number_of_points;
+      }
+    }
+    _dimension = _number_of_points > 0 ? space.get_dimension(points) : 0;
+
+    for (unsigned char i = 0; i < _number_of_points; ++i) {
+      for (unsigned char j = i + 1; j < _number_of_points; ++j) {
+        ++_cover[space.get_third(_points[i], _points[j])];
+      }
+    }
+    // the invariant is a histogram of the cover counts of the third points
+    // on all lines through the point, using 6 bits per bin
+    for (unsigned char i = 0; i < _number_of_points; ++i) {
+      for (unsigned char j = 0; j < _number_of_points; ++j) {
+        if (i != j) {
+          const unsigned char cover =
+              std::min<unsigned char>(
+                  _cover[space.get_third(_points[i], _points[j])], 10);
+          _invariant[_points[i]] += uint64_t(1) << (6 * (cover - 1));
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Run the search.
+   *
+   * @param number_of_automorphisms Variable to store the number of affine
+   * transformations of the entire space that map the set onto itself in.
+   * @return Canonical form of the set.
+   */
+  CardMask run(uint64_t &number_of_automorphisms) {
+    if (_number_of_points == 0) {
+      number_of_automorphisms = AffineSpace::NUMBER_OF_TRANSFORMATIONS;
+      return CardMask();
+    }
+    extend(0, nullptr, nullptr);
+    // every automorphism of the flat extends to as many transformations of
+    // the entire space as there are ways to complete the basis
+    number_of_automorphisms = _number_of_best;
+    unsigned char flat_size = 1;
+    for (unsigned char i = 0; i < _dimension; ++i) {
+      flat_size *= 3;
+    }
+    for (unsigned char i = _dimension; i < AffineSpace::DIMENSION; ++i) {
+      number_of_automorphisms *= AffineSpace::NUMBER_OF_POINTS - flat_size;
+      flat_size *= 3;
+    }
+    return _best;
+  }
+};
+
+/**
+ * @brief Constructor.
+ *
+ * Sets up the lookup tables, using the properties of the corresponding cards
+ * as coordinates.
+ */
+AffineSpace::AffineSpace() {
+  for (unsigned char point = 0; point < NUMBER_OF_POINTS; ++point) {
+    const Card &card = Card::get_card(point);
+    _coordinates[point][0] = card.get_number_of_symbols() - 1;
+    _coordinates[point][1] = card.get_colour();
+    _coordinates[point][2] = card.get_symbol();
+    _coordinates[point][3] = card.get_fill();
+  }
+  for (unsigned char a = 0; a < NUMBER_OF_POINTS; ++a) {
+    for (unsigned char b = 0; b < NUMBER_OF_POINTS; ++b) {
+      unsigned char sum[DIMENSION], difference[DIMENSION];
+      for (unsigned char axis = 0; axis < DIMENSION; ++axis) {
+        sum[axis] = (_coordinates[a][axis] + _coordinates[b][axis]) % 3;
+        difference[axis] =
+            (_coordinates[a][axis] + 3 - _coordinates[b][axis]) % 3;
+      }
+      _sum[a][b] = get_point(sum);
+      _difference[a][b] = get_point(difference);
+    }
+  }
+}
+
+/**
+ * @brief Get the space.
+ *
+ * The lookup tables are set up during the first call to this function.
+ *
+ * @return Constant reference to the space.
+ */
+const AffineSpace &AffineSpace::get_space() {
+  static const AffineSpace space;
+  return space;
+}
+
+/**
+ * @brief Get the point with the given coordinates.
+ *
+ * @param coordinates Coordinates (number - 1, colour, symbol, fill).
+ * @return Index of the card with these properties.
+ */
+unsigned char
+AffineSpace::get_point(const unsigned char coordinates[DIMENSION]) const {
+  return Card(coordinates[0] + 1,
+              static_cast<CardProperties::CardColour>(coordinates[1]),
+              static_cast<CardProperties::CardSymbol>(coordinates[2]),
+              static_cast<CardProperties::CardFill>(coordinates[3]))
+      .get_index();
+}
+
+/**
+ * @brief Check if the given points form a cap: if no three of them are on a
+ * line (make up a set).
+ *
+ * @param points Set of points.
+ * @return True if the points form a cap.
+ */
+bool AffineSpace::is_cap(const CardMask &points) const {
+  for (unsigned char a = 0; a < NUMBER_OF_POINTS; ++a) {
+    if (!points.contains(a)) {
+      continue;
+    }
+    for (unsigned char b = a + 1; b < NUMBER_OF_POINTS; ++b) {
+      if (points.contains(b) && points.contains(get_third(a, b))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Get the dimension of the smallest flat that contains all given
+ * points.
+ *
+ * @param points Non-empty set of points.
+ * @return Dimension of the flat spanned by the points (0-4).
+ */
+unsigned char AffineSpace::get_dimension(const CardMask &points) const {
+  CardMask flat;
+  unsigned char flat_points[NUMBER_OF_POINTS];
+  unsigned char flat_size = 0;
+  unsigned char dimension = 0;
+  unsigned char origin = NUMBER_OF_POINTS;
+  for (unsigned char point = 0; point < NUMBER_OF_POINTS; ++point) {
+    if (!points.contains(point) || flat.contains(point)) {
+      continue;
+    }
+    if (origin == NUMBER_OF_POINTS) {
+      origin = point;
+      flat.add(point);
+      flat_points[0] = point;
+      flat_size = 1;
+      continue;
+    }
+    const unsigned char vector = _difference[point][origin];
+    const unsigned char vector2 = _sum[vector][vector];
+    for (unsigned char i = 0; i < flat_size; ++i) {
+      flat_points[flat_size + i] = _sum[flat_points[i]][vector];
+      flat_points[2 * flat_size + i] = _sum[flat_points[i]][vector2];
+      flat.add(flat_points[flat_size + i]);
+      flat.add(flat_points[2 * flat_size + i]);
+    }
+    flat_size *= 3;
+    ++dimension;
+  }
+  assert(origin != NUMBER_OF_POINTS);
+  return dimension;
+}
+
+/**
+ * @brief Get the canonical form of the given set of points.
+ *
+ * Two sets of points can be mapped onto each other by an affine
+ * transformation if and only if they have the same canonical form. The
+ * canonical form is itself equivalent to the original set.
+ *
+ * @param points Set of points.
+ * @param number_of_automorphisms Variable to store the number of affine
+ * transformations that map the set onto itself in. The number of sets that
+ * are equivalent to the given set is NUMBER_OF_TRANSFORMATIONS divided by this
+ * number.
+ * @return Canonical form of the set.
+ */
+CardMask AffineSpace::get_canonical_form(
+    const CardMask &points, uint64_t &number_of_automorphisms) const {
+  CanonicalFormSearch search(*this, points);
+  return search.run(number_of_automorphisms);
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file AffineSpace.hpp
+ *
+ * @brief The cards of the game as points of the affine space AG(4,3).
+ *
+ * Every card attribute takes one of three values, so that the attributes of a
+ * card can be read as the coordinates of a point in a four dimensional vector
+ * space over the field with three elements. Three cards make up a set if and
+ * only if their coordinates add up to zero, which means that sets are exactly
+ * the lines of the space, and set-free boards are caps: collections of points
+ * without three points on a line.
+ *
+ * Affine transformations (invertible linear maps followed by a translation)
+ * map lines onto lines, so the number of sets on a board does not change
+ * under these transformations. There are 1,965,150,720 of them, and they
+ * collapse the huge number of possible boards into a small number of
+ * equivalence classes.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_AFFINESPACE_HPP
+#define OPENSET_AFFINESPACE_HPP
+
+#include "../engine/CardIndex.hpp"
+#include "../engine/CardMask.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Arithmetic on the points of AG(4,3) and canonical forms of sets of
+ * points.
+ *
+ * Points are identified with card indices. All arithmetic is done using
+ * lookup tables that are set up once, from the card properties.
+ */
+class AffineSpace {
+public:
+  /*! @brief Dimension of the space: the number of card attributes. */
+  static const unsigned char DIMENSION = 4;
+
+  /*! @brief Number of points in the space: the number of cards. */
+  static const unsigned char NUMBER_OF_POINTS = CardIndex::CARDINDEX_COUNTER;
+
+  /*! @brief Number of affine transformations of the space. */
+  static const uint64_t NUMBER_OF_TRANSFORMATIONS = 1965150720u;
+
+  /*! @brief Maximum number of points in a cap (a set of points without three
+   *  points on a line). */
+  static const unsigned char MAXIMUM_CAP_SIZE = 20;
+
+private:
+  /*! @brief Coordinates of every point. */
+  unsigned char _coordinates[NUMBER_OF_POINTS][DIMENSION];
+
+  /*! @brief Sum of two points, as vectors. */
+  unsigned char _sum[NUMBER_OF_POINTS][NUMBER_OF_POINTS];
+
+  /*! @brief Difference of two points: the vector from the second point to the
+   *  first. */
+  unsigned char _difference[NUMBER_OF_POINTS][NUMBER_OF_POINTS];
+
+  AffineSpace();
+
+public:
+  static const AffineSpace &get_space();
+
+  unsigned char get_point(const unsigned char coordinates[DIMENSION]) const;
+
+  /**
+   * @brief Get a coordinate of the given point.
+   *
+   * @param point Point.
+   * @param axis Coordinate axis (0-3: number, colour, symbol, fill).
+   * @return Coordinate of the point along that axis (0-2).
+   */
+  inline unsigned char get_coordinate(unsigned char point,
+                                      unsigned char axis) const {
+    return _coordinates[point][axis];
+  }
+
+  /**
+   * @brief Add two points as vectors.
+   *
+   * @param a First point.
+   * @param b Second point.
+   * @return Sum of both points.
+   */
+  inline unsigned char get_sum(unsigned char a, unsigned char b) const {
+    return _sum[a][b];
+  }
+
+  /**
+   * @brief Subtract two points.
+   *
+   * @param a First point.
+   * @param b Second point.
+   * @return Vector from b to a (as a point).
+   */
+  inline unsigned char get_difference(unsigned char a, unsigned char b) const {
+    return _difference[a][b];
+  }
+
+  /**
+   * @brief Get the third point on the line through two different points: the
+   * card that completes a set with the two given cards.
+   *
+   * This is the third card table of the classic rules.
+   *
+   * @param a First point.
+   * @param b Second point.
+   * @return Third point on the line through a and b.
+   */
+  inline unsigned char get_third(unsigned char a, unsigned char b) const {
+    return CardIndex::ClassicRules::get_third_card(a, b);
+  }
+
+  bool is_cap(const CardMask &points) const;
+  unsigned char get_dimension(const CardMask &points) const;
+
+  CardMask get_canonical_form(const CardMask &points,
+                              uint64_t &number_of_automorphisms) const;
+};
+
+#endif // OPENSET_AFFINESPACE_HPP
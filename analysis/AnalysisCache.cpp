@@ -0,0 +1,439 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file AnalysisCache.cpp
+ *
+ * @brief Persistent cache of board analyses: implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "AnalysisCache.hpp"
+#include "../engine/GameState.hpp"
+#include "BoardHash.hpp"
+
+#include <cassert>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Count the number of ways to add 3 of the given candidate cards to
+ * the given set-free board without creating a set.
+ *
+ * @param board Mask of a set-free board.
+ * @param candidates Indices of the cards that can be added.
+ * @param number_of_candidates Number of candidate cards.
+ * @return Number of set-free boards with 3 more cards.
+ */
+static uint32_t count_set_free_deals(const CardMask &board,
+                                     const unsigned char *candidates,
+                                     unsigned char number_of_candidates) {
+  // a candidate that completes a set with two cards on the board is never
+  // part of a set-free deal
+  CardMask blocked = board;
+  unsigned char cards[GameState::MAX_BOARD_SIZE];
+  unsigned char number_of_cards = 0;
+  for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER; ++card) {
+    if (board.contains(card)) {
+      for (unsigned char i = 0; i < number_of_cards; ++i) {
+        blocked.add(CardIndex::ClassicRules::get_third_card(cards[i], card));
+      }
+      cards[number_of_cards] = card;
+      ++number_of_cards;
+    }
+  }
+  unsigned char free_cards[CardIndex::CARDINDEX_COUNTER];
+  unsigned char number_of_free_cards = 0;
+  for (unsigned char i = 0; i < number_of_candidates; ++i) {
+    if (!blocked.contains(candidates[i])) {
+      free_cards[number_of_free_cards] = candidates[i];
+      ++number_of_free_cards;
+    }
+  }
+
+  // the remaining sets contain two of the new cards and a card on the
+  // board, or three new cards
+  uint32_t number_of_deals = 0;
+  for (unsigned char i = 0; i < number_of_free_cards; ++i) {
+    const unsigned char a = free_cards[i];
+    for (unsigned char j = i + 1; j < number_of_free_cards; ++j) {
+      const unsigned char b = free_cards[j];
+      const unsigned char third_ab =
+          CardIndex::ClassicRules::get_third_card(a, b);
+      if (board.contains(third_ab)) {
+        continue;
+      }
+      for (unsigned char k = j + 1; k < number_of_free_cards; ++k) {
+        const unsigned char c = free_cards[k];
+        if (c != third_ab &&
+            !board.contains(CardIndex::ClassicRules::get_third_card(a, c)) &&
+            !board.contains(CardIndex::ClassicRules::get_third_card(b, c))) {
+          ++number_of_deals;
+        }
+      }
+    }
+  }
+  return number_of_deals;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Maps the given cache file into memory. If the file does not exist, a new
+ * empty cache is created.
+ *
+ * @param filename Name of the cache file.
+ * @param capacity Number of slots in a new cache (rounded up to a power of
+ * 2). Ignored if the file already exists.
+ * @param symmetric Should a new cache use keys that are invariant under
+ * attribute permutations? Ignored if the file already exists.
+ */
+AnalysisCache::AnalysisCache(std::string filename, uint64_t capacity,
+                             bool symmetric)
+    : _data(NULL), _size(0), _number_of_hits(0), _number_of_misses(0) {
+  const int file_descriptor = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+  if (file_descriptor < 0) {
+    return;
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0) {
+    ::close(file_descriptor);
+    return;
+  }
+
+  const bool is_new = file_status.st_size == 0;
+  size_t size = file_status.st_size;
+  if (is_new) {
+    uint64_t power_of_two = 1;
+    while (power_of_two < capacity) {
+      power_of_two <<= 1;
+    }
+    capacity = power_of_two;
+    // the file is sparse: slots only take up disk space once they are used
+    size = sizeof(AnalysisCacheHeader) + capacity * sizeof(Entry);
+    if (ftruncate(file_descriptor, size) != 0) {
+      ::close(file_descriptor);
+      return;
+    }
+  }
+  if (size >= sizeof(AnalysisCacheHeader)) {
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      file_descriptor, 0);
+    if (data != MAP_FAILED) {
+      // lookups hit random slots
+      madvise(data, size, MADV_RANDOM);
+      _data = static_cast<unsigned char *>(data);
+      _size = size;
+    }
+  }
+  // the mapping stays valid after the file is closed
+  ::close(file_descriptor);
+  if (_data == NULL) {
+    return;
+  }
+
+  AnalysisCacheHeader &header = get_header();
+  if (is_new) {
+    header._magic = AnalysisCacheHeader::MAGIC;
+    header._version = AnalysisCacheHeader::VERSION;
+    header._symmetric = symmetric;
+    header._capacity = capacity;
+    header._number_of_entries = 0;
+  } else if (header._magic != AnalysisCacheHeader::MAGIC ||
+             header._version != AnalysisCacheHeader::VERSION ||
+             header._capacity == 0 ||
+             (header._capacity & (header._capacity - 1)) != 0 ||
+             _size != sizeof(AnalysisCacheHeader) +
+                          header._capacity * sizeof(Entry)) {
+    munmap(_data, _size);
+    _data = NULL;
+    _size = 0;
+  }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unmaps the file. The kernel writes the changes back to disk.
+ */
+AnalysisCache::~AnalysisCache() {
+  if (_data != NULL) {
+    munmap(_data, _size);
+  }
+}
+
+/**
+ * @brief Get the header of the mapped file.
+ *
+ * @return Reference to the header.
+ */
+AnalysisCacheHeader &AnalysisCache::get_header() const {
+  return *reinterpret_cast<AnalysisCacheHeader *>(_data);
+}
+
+/**
+ * @brief Find the slot for the given key.
+ *
+ * @param key Key.
+ * @return Slot that contains the key, or the empty slot where the key should
+ * be inserted.
+ */
+AnalysisCache::Entry *AnalysisCache::find(const CardMask &key) const {
+  Entry *entries =
+      reinterpret_cast<Entry *>(_data + sizeof(AnalysisCacheHeader));
+  const uint64_t slot_mask = get_header()._capacity - 1;
+  // the table is never full, so this always terminates
+  uint64_t slot = BoardHash::get_hash(key) & slot_mask;
+  while (entries[slot]._occupied &&
+         (entries[slot]._key[0] != key.get_word(0) ||
+          entries[slot]._key[1] != key.get_word(1))) {
+    slot = (slot + 1) & slot_mask;
+  }
+  return &entries[slot];
+}
+
+/**
+ * @brief Check if the cache file was mapped successfully.
+ *
+ * @return True if the cache can be used.
+ */
+bool AnalysisCache::is_valid() const { return _data != NULL; }
+
+/**
+ * @brief Check if the keys are invariant under attribute permutations.
+ *
+ * @return True if boards that only differ by an attribute permutation share
+ * an entry.
+ */
+bool AnalysisCache::is_symmetric() const {
+  assert(is_valid());
+  return get_header()._symmetric != 0;
+}
+
+/**
+ * @brief Get the number of slots in the table.
+ *
+ * @return Number of slots.
+ */
+uint64_t AnalysisCache::get_capacity() const {
+  assert(is_valid());
+  return get_header()._capacity;
+}
+
+/**
+ * @brief Get the number of boards in the cache.
+ *
+ * @return Number of occupied slots.
+ */
+uint64_t AnalysisCache::get_number_of_entries() const {
+  assert(is_valid());
+  return get_header()._number_of_entries;
+}
+
+/**
+ * @brief Get the number of lookups that found an entry.
+ *
+ * @return Number of hits.
+ */
+unsigned long AnalysisCache::get_number_of_hits() const {
+  return _number_of_hits;
+}
+
+/**
+ * @brief Get the number of lookups that did not find an entry.
+ *
+ * @return Number of misses.
+ */
+unsigned long AnalysisCache::get_number_of_misses() const {
+  return _number_of_misses;
+}
+
+/**
+ * @brief Look up the analysis of the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @param analysis Variable to store the analysis in (only set if the board
+ * was found).
+ * @return True if the board was found.
+ */
+bool AnalysisCache::lookup(const unsigned char *board,
+                           unsigned char board_size,
+                           BoardAnalysis &analysis) {
+  assert(is_valid());
+  CardMask key = BoardHash::get_mask(board, board_size);
+  unsigned char permutation = BoardHash::IDENTITY_PERMUTATION;
+  if (is_symmetric()) {
+    key = BoardHash::get_symmetric_mask(key, permutation);
+  }
+  const Entry *entry = find(key);
+  if (!entry->_occupied) {
+    ++_number_of_misses;
+    return false;
+  }
+  ++_number_of_hits;
+  analysis = entry->_analysis;
+  if (permutation != BoardHash::IDENTITY_PERMUTATION &&
+      analysis._best_move[0] != BoardAnalysis::NO_MOVE) {
+    const unsigned char inverse = BoardHash::get_inverse(permutation);
+    for (unsigned char i = 0; i < 3; ++i) {
+      analysis._best_move[i] =
+          BoardHash::permute(analysis._best_move[i], inverse);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Store the analysis of the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @param analysis Analysis of the board.
+ * @return True if the analysis was stored, false if the cache is full.
+ */
+bool AnalysisCache::insert(const unsigned char *board,
+                           unsigned char board_size,
+                           const BoardAnalysis &analysis) {
+  assert(is_valid());
+  CardMask key = BoardHash::get_mask(board, board_size);
+  unsigned char permutation = BoardHash::IDENTITY_PERMUTATION;
+  if (is_symmetric()) {
+    key = BoardHash::get_symmetric_mask(key, permutation);
+  }
+  Entry *entry = find(key);
+  AnalysisCacheHeader &header = get_header();
+  if (!entry->_occupied) {
+    // keep at least a quarter of the slots empty, so that probe sequences
+    // stay short
+    if (4 * (header._number_of_entries + 1) > 3 * header._capacity) {
+      return false;
+    }
+    entry->_key[0] = key.get_word(0);
+    entry->_key[1] = key.get_word(1);
+    entry->_occupied = 1;
+    ++header._number_of_entries;
+  }
+  entry->_analysis = analysis;
+  if (permutation != BoardHash::IDENTITY_PERMUTATION &&
+      analysis._best_move[0] != BoardAnalysis::NO_MOVE) {
+    for (unsigned char i = 0; i < 3; ++i) {
+      entry->_analysis._best_move[i] =
+          BoardHash::permute(analysis._best_move[i], permutation);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Get the analysis of the given board.
+ *
+ * The analysis is looked up in the cache. If the board is not in the cache,
+ * it is analyzed and added to the cache.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @return Analysis of the board.
+ */
+BoardAnalysis AnalysisCache::get_analysis(const unsigned char *board,
+                                          unsigned char board_size) {
+  BoardAnalysis analysis;
+  if (!lookup(board, board_size, analysis)) {
+    analysis = analyze(board, board_size);
+    insert(board, board_size, analysis);
+  }
+  return analysis;
+}
+
+/**
+ * @brief Analyze the given board.
+ *
+ * We count the sets on the board, and for every set, we count the number of
+ * ways in which the next 3 cards can be dealt from the cards that are not on
+ * the board, and how many of these deals result in a board without sets. The
+ * best move is the set that leads to the smallest number of stalls. If the
+ * board does not contain a set, the deal adds 3 cards to the full board.
+ *
+ * @param board Indices of distinct cards on the board.
+ * @param board_size Number of cards on the board (at most
+ * GameState::MAX_BOARD_SIZE).
+ * @return Analysis of the board.
+ */
+BoardAnalysis AnalysisCache::analyze(const unsigned char *board,
+                                     unsigned char board_size) {
+  assert(board_size <= GameState::MAX_BOARD_SIZE);
+
+  const CardMask mask = BoardHash::get_mask(board, board_size);
+  unsigned char candidates[CardIndex::CARDINDEX_COUNTER];
+  unsigned char number_of_candidates = 0;
+  for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER; ++card) {
+    if (!mask.contains(card)) {
+      candidates[number_of_candidates] = card;
+      ++number_of_candidates;
+    }
+  }
+
+  BoardAnalysis analysis;
+  analysis._number_of_deals = uint32_t(number_of_candidates) *
+                              (number_of_candidates - 1) *
+                              (number_of_candidates - 2) / 6;
+  unsigned char sets[GameState::MAX_BOARD_SIZE *
+                     (GameState::MAX_BOARD_SIZE - 1) / 2];
+  analysis._number_of_sets =
+      CardIndex::ClassicRules::find_all_sets(board, board_size, sets);
+  if (analysis._number_of_sets == 0) {
+    analysis._best_move[0] = BoardAnalysis::NO_MOVE;
+    analysis._best_move[1] = BoardAnalysis::NO_MOVE;
+    analysis._best_move[2] = BoardAnalysis::NO_MOVE;
+    analysis._number_of_stalls =
+        count_set_free_deals(mask, candidates, number_of_candidates);
+    return analysis;
+  }
+
+  for (unsigned char i = 0; i < analysis._number_of_sets; ++i) {
+    // the board without the set: if it still contains a set, no deal can
+    // cause a stall
+    CardMask remaining = mask;
+    for (unsigned char j = 0; j < 3; ++j) {
+      remaining.remove(board[sets[3 * i + j]]);
+    }
+    unsigned char remaining_cards[GameState::MAX_BOARD_SIZE];
+    unsigned char number_of_remaining_cards = 0;
+    for (unsigned char j = 0; j < board_size; ++j) {
+      if (remaining.contains(board[j])) {
+        remaining_cards[number_of_remaining_cards] = board[j];
+        ++number_of_remaining_cards;
+      }
+    }
+    const uint32_t number_of_stalls =
+        CardIndex::ClassicRules::has_set(remaining_cards,
+                                         number_of_remaining_cards)
+            ? 0
+            : count_set_free_deals(remaining, candidates,
+                                   number_of_candidates);
+    if (i == 0 || number_of_stalls < analysis._number_of_stalls) {
+      analysis._number_of_stalls = number_of_stalls;
+      for (unsigned char j = 0; j < 3; ++j) {
+        analysis._best_move[j] = board[sets[3 * i + j]];
+      }
+    }
+  }
+  return analysis;
+}
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file AnalysisCache.hpp
+ *
+ * @brief Persistent cache of board analyses.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_ANALYSISCACHE_HPP
+#define OPENSET_ANALYSISCACHE_HPP
+
+#include "../engine/CardMask.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Analysis of a single board.
+ */
+struct BoardAnalysis {
+  /*! @brief Value of _best_move for boards without a set. */
+  static const unsigned char NO_MOVE = 0xff;
+
+  /*! @brief Number of sets on the board. */
+  unsigned char _number_of_sets;
+
+  /*! @brief Indices of the cards in the best set: the set that minimizes the
+   *  probability of a stall on the next deal (NO_MOVE if there is no set). */
+  unsigned char _best_move[3];
+
+  /*! @brief Number of ways to deal the next 3 cards that leave a board
+   *  without sets, after taking the best set. */
+  uint32_t _number_of_stalls;
+
+  /*! @brief Total number of ways to deal the next 3 cards. */
+  uint32_t _number_of_deals;
+
+  /**
+   * @brief Get the probability of a stall on the next deal.
+   *
+   * @return Probability that the next board does not contain a set.
+   */
+  inline double get_stall_probability() const {
+    return static_cast<double>(_number_of_stalls) / _number_of_deals;
+  }
+};
+
+/**
+ * @brief Header at the start of an analysis cache file.
+ */
+struct AnalysisCacheHeader {
+  /*! @brief Magic number at the start of every cache file ("OSAC"). */
+  static const uint32_t MAGIC = 0x4341534fu;
+
+  /*! @brief Version of the cache format. */
+  static const uint16_t VERSION = 1;
+
+  /*! @brief Magic number (MAGIC). */
+  uint32_t _magic;
+
+  /*! @brief Version of the format (VERSION). */
+  uint16_t _version;
+
+  /*! @brief Are the keys invariant under attribute permutations? */
+  uint16_t _symmetric;
+
+  /*! @brief Number of slots in the table (a power of 2). */
+  uint64_t _capacity;
+
+  /*! @brief Number of occupied slots. */
+  uint64_t _number_of_entries;
+
+  /*! @brief Padding that keeps the table aligned to a cache line. */
+  char _padding[40];
+};
+
+/**
+ * @brief Persistent cache of board analyses.
+ *
+ * The cache is an open addressing hash table with linear probing that lives
+ * in a memory-mapped file. Boards are keyed by their membership mask (the
+ * mask itself is stored, so different boards never share an entry), and the
+ * slot is chosen by the hash of the mask (see BoardHash.hpp). A lookup of a
+ * board that was analyzed before, possibly by an earlier process, touches a
+ * single 32 byte slot, which in practice means a single page that is already
+ * in the page cache.
+ *
+ * If the cache is symmetric, boards are keyed by their symmetric mask, so that
+ * boards that only differ by an attribute permutation share a single entry.
+ * The best move is then stored in the frame of the symmetric mask, and mapped
+ * back onto the cards of the board that is looked up.
+ *
+ * The table has a fixed capacity, which is set when the file is created, and
+ * does not accept new entries once it is 3/4 full. The cache can be used by a
+ * single process at a time.
+ */
+class AnalysisCache {
+private:
+  /**
+   * @brief Slot in the table.
+   */
+  struct Entry {
+    /*! @brief Key: the two words of the (symmetric) mask. */
+    uint64_t _key[2];
+
+    /*! @brief Analysis. */
+    BoardAnalysis _analysis;
+
+    /*! @brief Is the slot occupied? */
+    uint32_t _occupied;
+  };
+
+  /*! @brief Mapped file (NULL if the file could not be mapped). */
+  unsigned char *_data;
+
+  /*! @brief Size of the mapped file (in bytes). */
+  size_t _size;
+
+  /*! @brief Number of lookups that found an entry. */
+  unsigned long _number_of_hits;
+
+  /*! @brief Number of lookups that did not find an entry. */
+  unsigned long _number_of_misses;
+
+  AnalysisCacheHeader &get_header() const;
+  Entry *find(const CardMask &key) const;
+
+public:
+  AnalysisCache(std::string filename, uint64_t capacity = 1 << 20,
+                bool symmetric = false);
+  ~AnalysisCache();
+
+  // the mapping cannot be shared between caches
+  AnalysisCache(const AnalysisCache &) = delete;
+  AnalysisCache &operator=(const AnalysisCache &) = delete;
+
+  bool is_valid() const;
+  bool is_symmetric() const;
+  uint64_t get_capacity() const;
+  uint64_t get_number_of_entries() const;
+  unsigned long get_number_of_hits() const;
+  unsigned long get_number_of_misses() const;
+
+  bool lookup(const unsigned char *board, unsigned char board_size,
+              BoardAnalysis &analysis);
+  bool insert(const unsigned char *board, unsigned char board_size,
+              const BoardAnalysis &analysis);
+  BoardAnalysis get_analysis(const unsigned char *board,
+                             unsigned char board_size);
+
+  static BoardAnalysis analyze(const unsigned char *board,
+                               unsigned char board_size);
+};
+
+#endif // OPENSET_ANALYSISCACHE_HPP
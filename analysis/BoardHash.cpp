@@ -0,0 +1,252 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file BoardHash.cpp
+ *
+ * @brief Canonical keys and hashes of boards: implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "BoardHash.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Table containing the image of every card under every attribute
+ * permutation.
+ *
+ * The table is fully computed at compile time.
+ */
+class PermutationTable {
+private:
+  /*! @brief Image of every card under every permutation. */
+  unsigned char _images[BoardHash::NUMBER_OF_PERMUTATIONS]
+                       [CardIndex::CARDINDEX_COUNTER];
+
+  /*! @brief Inverse of every permutation. */
+  unsigned char _inverses[BoardHash::NUMBER_OF_PERMUTATIONS];
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * Permutations are numbered in lexicographic order, so that permutation 0
+   * is the identity. Permutation p moves the value of attribute i to
+   * attribute axes[p][i].
+   */
+  constexpr PermutationTable() : _images{}, _inverses{} {
+    const unsigned char number_of_attributes =
+        CardIndex::ClassicRules::NUMBER_OF_ATTRIBUTES;
+    unsigned char axes[BoardHash::NUMBER_OF_PERMUTATIONS]
+                      [CardIndex::ClassicRules::NUMBER_OF_ATTRIBUTES] = {};
+    unsigned char number_of_permutations = 0;
+    for (unsigned int code = 0; code < 256; ++code) {
+      // decode 4 base-4 digits, most significant first, and only keep codes
+      // without repeated digits
+      unsigned char axis[number_of_attributes] = {};
+      unsigned int used = 0;
+      for (unsigned char i = 0; i < number_of_attributes; ++i) {
+        axis[i] = (code >> (2 * (number_of_attributes - 1 - i))) & 3;
+        used |= 1u << axis[i];
+      }
+      if (used == 15) {
+        for (unsigned char i = 0; i < number_of_attributes; ++i) {
+          axes[number_of_permutations][i] = axis[i];
+        }
+        ++number_of_permutations;
+      }
+    }
+
+    for (unsigned char p = 0; p < BoardHash::NUMBER_OF_PERMUTATIONS; ++p) {
+      for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER;
+           ++card) {
+        unsigned char values[number_of_attributes] = {};
+        for (unsigned char i = 0; i < number_of_attributes; ++i) {
+          values[axes[p][i]] = CardIndex::ClassicRules::get_value(card, i);
+        }
+        _images[p][card] = CardIndex::ClassicRules::get_index(values);
+      }
+      for (unsigned char q = 0; q < BoardHash::NUMBER_OF_PERMUTATIONS; ++q) {
+        bool inverse = true;
+        for (unsigned char i = 0; i < number_of_attributes; ++i) {
+          inverse = inverse && axes[q][axes[p][i]] == i;
+        }
+        if (inverse) {
+          _inverses[p] = q;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Get the image of the given card under the given permutation.
+   *
+   * @param permutation Permutation.
+   * @param card Index of a card.
+   * @return Index of the image card.
+   */
+  constexpr unsigned char get_image(unsigned char permutation,
+                                    unsigned char card) const {
+    return _images[permutation][card];
+  }
+
+  /**
+   * @brief Get the inverse of the given permutation.
+   *
+   * @param permutation Permutation.
+   * @return Inverse permutation.
+   */
+  constexpr unsigned char get_inverse(unsigned char permutation) const {
+    return _inverses[permutation];
+  }
+};
+
+/*! @brief Table containing all attribute permutations. */
+static constexpr PermutationTable PERMUTATION_TABLE;
+
+/**
+ * @brief Get the membership mask of the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @return Membership mask: the canonical key of the board.
+ */
+CardMask BoardHash::get_mask(const unsigned char *board,
+                             unsigned char board_size) {
+  CardMask mask;
+  for (unsigned char i = 0; i < board_size; ++i) {
+    mask.add(board[i]);
+  }
+  return mask;
+}
+
+/**
+ * @brief Get the hash of the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @return 64-bit hash that does not depend on the order of the cards.
+ */
+uint64_t BoardHash::get_hash(const unsigned char *board,
+                             unsigned char board_size) {
+  return get_hash(get_mask(board, board_size));
+}
+
+/**
+ * @brief Get the image of the given card under the given attribute
+ * permutation.
+ *
+ * @param card Index of a card.
+ * @param permutation Permutation (0 - NUMBER_OF_PERMUTATIONS-1).
+ * @return Index of the image card.
+ */
+unsigned char BoardHash::permute(unsigned char card,
+                                 unsigned char permutation) {
+  assert(permutation < NUMBER_OF_PERMUTATIONS);
+  return PERMUTATION_TABLE.get_image(permutation, card);
+}
+
+/**
+ * @brief Get the inverse of the given attribute permutation.
+ *
+ * @param permutation Permutation (0 - NUMBER_OF_PERMUTATIONS-1).
+ * @return Permutation that undoes the given permutation.
+ */
+unsigned char BoardHash::get_inverse(unsigned char permutation) {
+  assert(permutation < NUMBER_OF_PERMUTATIONS);
+  return PERMUTATION_TABLE.get_inverse(permutation);
+}
+
+/**
+ * @brief Get the image of the given mask under the given attribute
+ * permutation.
+ *
+ * @param mask Membership mask of a board.
+ * @param permutation Permutation (0 - NUMBER_OF_PERMUTATIONS-1).
+ * @return Membership mask of the image board.
+ */
+CardMask BoardHash::permute(const CardMask &mask, unsigned char permutation) {
+  assert(permutation < NUMBER_OF_PERMUTATIONS);
+  CardMask image;
+  for (unsigned char word = 0; word < 2; ++word) {
+    uint64_t bits = mask.get_word(word);
+    while (bits != 0) {
+      const unsigned char card = 64 * word + __builtin_ctzll(bits);
+      image.add(PERMUTATION_TABLE.get_image(permutation, card));
+      bits &= bits - 1;
+    }
+  }
+  return image;
+}
+
+/**
+ * @brief Get the symmetric key of the given board: the smallest mask over all
+ * attribute permutations of the board.
+ *
+ * @param mask Membership mask of a board.
+ * @param permutation Variable to store a permutation that maps the board onto
+ * its symmetric key in.
+ * @return Symmetric key.
+ */
+CardMask BoardHash::get_symmetric_mask(const CardMask &mask,
+                                       unsigned char &permutation) {
+  // gather the cards once, so that every permutation is a table lookup per
+  // card
+  unsigned char cards[CardIndex::CARDINDEX_COUNTER];
+  unsigned char number_of_cards = 0;
+  for (unsigned char word = 0; word < 2; ++word) {
+    uint64_t bits = mask.get_word(word);
+    while (bits != 0) {
+      cards[number_of_cards] = 64 * word + __builtin_ctzll(bits);
+      ++number_of_cards;
+      bits &= bits - 1;
+    }
+  }
+
+  CardMask best = mask;
+  permutation = IDENTITY_PERMUTATION;
+  for (unsigned char p = 1; p < NUMBER_OF_PERMUTATIONS; ++p) {
+    CardMask image;
+    for (unsigned char i = 0; i < number_of_cards; ++i) {
+      image.add(PERMUTATION_TABLE.get_image(p, cards[i]));
+    }
+    if (image.get_word(1) < best.get_word(1) ||
+        (image.get_word(1) == best.get_word(1) &&
+         image.get_word(0) < best.get_word(0))) {
+      best = image;
+      permutation = p;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Get the symmetric hash of the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @return 64-bit hash that does not depend on the order of the cards, and is
+ * the same for boards that only differ by an attribute permutation.
+ */
+uint64_t BoardHash::get_symmetric_hash(const unsigned char *board,
+                                       unsigned char board_size) {
+  unsigned char permutation;
+  return get_hash(get_symmetric_mask(get_mask(board, board_size),
+                                     permutation));
+}
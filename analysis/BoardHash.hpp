@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file BoardHash.hpp
+ *
+ * @brief Canonical keys and hashes of boards.
+ *
+ * A board is an unordered collection of cards: the order of the cards on the
+ * main deck does not matter for any analysis of the board. The membership
+ * mask of the cards on the board is therefore an exact canonical key, and a
+ * 64-bit hash of that mask is a hash that does not depend on the slot order.
+ *
+ * Renaming the attributes of all cards (e.g. swapping the roles of colour and
+ * fill) maps sets onto sets, so boards that only differ by such a renaming
+ * have the same analysis, up to the same renaming. The symmetric key of a
+ * board is the smallest mask over all 24 attribute permutations of the
+ * board.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_BOARDHASH_HPP
+#define OPENSET_BOARDHASH_HPP
+
+#include "../engine/CardMask.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Canonical keys and hashes of boards.
+ */
+namespace BoardHash {
+
+/*! @brief Number of attribute permutations. */
+const static unsigned char NUMBER_OF_PERMUTATIONS = 24;
+
+/*! @brief Index of the identity permutation. */
+const static unsigned char IDENTITY_PERMUTATION = 0;
+
+/**
+ * @brief Get the hash of the given mask.
+ *
+ * @param mask Membership mask of a board.
+ * @return 64-bit hash of the mask.
+ */
+inline uint64_t get_hash(const CardMask &mask) {
+  // the 64-bit finalizer of MurmurHash3: every input bit affects every output
+  // bit
+  uint64_t hash = mask.get_word(0) ^ (mask.get_word(1) * 0x9e3779b97f4a7c15ull);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+CardMask get_mask(const unsigned char *board, unsigned char board_size);
+uint64_t get_hash(const unsigned char *board, unsigned char board_size);
+
+unsigned char permute(unsigned char card, unsigned char permutation);
+unsigned char get_inverse(unsigned char permutation);
+CardMask permute(const CardMask &mask, unsigned char permutation);
+
+CardMask get_symmetric_mask(const CardMask &mask,
+                            unsigned char &permutation);
+uint64_t get_symmetric_hash(const unsigned char *board,
+                            unsigned char board_size);
+}
+
+#endif // OPENSET_BOARDHASH_HPP
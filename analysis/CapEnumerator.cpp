@@ -0,0 +1,347 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file CapEnumerator.cpp
+ *
+ * @brief Exact enumeration of set-free boards up to symmetry:
+ * implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "CapEnumerator.hpp"
+#include "../parallel/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+
+/**
+ * @brief Constructor.
+ *
+ * The enumeration starts from the empty board.
+ *
+ * @param pool Pool that executes the extensions.
+ * @param checkpoint_filename Name of the checkpoint file (empty: do not write
+ * checkpoints).
+ * @param chunk_size Number of classes that is extended between two
+ * checkpoints.
+ */
+CapEnumerator::CapEnumerator(WorkStealingPool &pool,
+                             std::string checkpoint_filename,
+                             unsigned long chunk_size)
+    : _space(AffineSpace::get_space()), _pool(pool),
+      _checkpoint_filename(checkpoint_filename), _chunk_size(chunk_size),
+      _size(0), _next_class(0), _classes_per_size{}, _caps_per_size{} {
+  assert(chunk_size > 0);
+  _classes.push_back({CardMask(), AffineSpace::NUMBER_OF_TRANSFORMATIONS});
+  _classes_per_size[0] = 1;
+  _caps_per_size[0] = 1;
+}
+
+/**
+ * @brief Extend a single class with every card that does not complete a set.
+ *
+ * @param cap_class Class to extend.
+ * @param next_classes Map to add the canonical forms of the extensions to.
+ */
+void CapEnumerator::extend(const CapClass &cap_class,
+                           CapMap &next_classes) const {
+  unsigned char points[AffineSpace::MAXIMUM_CAP_SIZE];
+  unsigned char number_of_points = 0;
+  for (unsigned char point = 0; point < AffineSpace::NUMBER_OF_POINTS;
+       ++point) {
+    if (cap_class._cap.contains(point)) {
+      points[number_of_points] = point;
+      ++number_of_points;
+    }
+  }
+  CardMask blocked = cap_class._cap;
+  for (unsigned char i = 0; i < number_of_points; ++i) {
+    for (unsigned char j = i + 1; j < number_of_points; ++j) {
+      blocked.add(_space.get_third(points[i], points[j]));
+    }
+  }
+  for (unsigned char point = 0; point < AffineSpace::NUMBER_OF_POINTS;
+       ++point) {
+    if (blocked.contains(point)) {
+      continue;
+    }
+    CardMask cap = cap_class._cap;
+    cap.add(point);
+    uint64_t number_of_automorphisms;
+    const CardMask canonical_form =
+        _space.get_canonical_form(cap, number_of_automorphisms);
+    next_classes[canonical_form] = number_of_automorphisms;
+  }
+}
+
+/**
+ * @brief Replace the classes of size _size by the classes of size _size + 1
+ * once all of them have been extended.
+ */
+void CapEnumerator::finish_size() {
+  assert(_next_class == _classes.size());
+  _classes.clear();
+  uint64_t number_of_caps = 0;
+  for (auto it = _next_classes.begin(); it != _next_classes.end(); ++it) {
+    _classes.push_back({it->first, it->second});
+    number_of_caps +=
+        AffineSpace::NUMBER_OF_TRANSFORMATIONS / it->second;
+  }
+  // the order of the classes determines the order of the checkpoints, and
+  // should not depend on the number of threads
+  std::sort(_classes.begin(), _classes.end(),
+            [](const CapClass &a, const CapClass &b) {
+              return a._cap.get_word(1) < b._cap.get_word(1) ||
+                     (a._cap.get_word(1) == b._cap.get_word(1) &&
+                      a._cap.get_word(0) < b._cap.get_word(0));
+            });
+  _next_classes.clear();
+  _next_class = 0;
+  ++_size;
+  _classes_per_size[_size] = _classes.size();
+  _caps_per_size[_size] = number_of_caps;
+}
+
+/**
+ * @brief Write the current state of the enumeration to the checkpoint file.
+ *
+ * The checkpoint is written to a temporary file that then replaces the
+ * checkpoint file, so that an interruption while writing never destroys the
+ * previous checkpoint.
+ *
+ * @return True if the checkpoint was written successfully (or if no
+ * checkpoint file was set).
+ */
+bool CapEnumerator::write_checkpoint() const {
+  if (_checkpoint_filename.empty()) {
+    return true;
+  }
+
+  CapCheckpointHeader header = CapCheckpointHeader();
+  header._magic = CapCheckpointHeader::MAGIC;
+  header._version = CapCheckpointHeader::VERSION;
+  header._size = _size;
+  header._number_of_classes = _classes.size();
+  header._next_class = _next_class;
+  header._number_of_next_classes = _next_classes.size();
+  for (unsigned char size = 0; size <= _size; ++size) {
+    header._classes_per_size[size] = _classes_per_size[size];
+    header._caps_per_size[size] = _caps_per_size[size];
+  }
+
+  const std::string temporary_filename = _checkpoint_filename + ".tmp";
+  std::ofstream file(temporary_filename, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (auto it = _classes.begin(); it != _classes.end(); ++it) {
+    const uint64_t record[3] = {it->_cap.get_word(0), it->_cap.get_word(1),
+                                it->_number_of_automorphisms};
+    file.write(reinterpret_cast<const char *>(record), sizeof(record));
+  }
+  for (auto it = _next_classes.begin(); it != _next_classes.end(); ++it) {
+    const uint64_t record[3] = {it->first.get_word(0), it->first.get_word(1),
+                                it->second};
+    file.write(reinterpret_cast<const char *>(record), sizeof(record));
+  }
+  file.close();
+  if (!file.good()) {
+    return false;
+  }
+  return std::rename(temporary_filename.c_str(),
+                     _checkpoint_filename.c_str()) == 0;
+}
+
+/**
+ * @brief Resume the enumeration from the checkpoint file.
+ *
+ * @return True if a valid checkpoint was read. If not, the state of the
+ * enumeration is not changed.
+ */
+bool CapEnumerator::load_checkpoint() {
+  if (_checkpoint_filename.empty()) {
+    return false;
+  }
+  std::ifstream file(_checkpoint_filename, std::ios::binary);
+  CapCheckpointHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      header._magic != CapCheckpointHeader::MAGIC ||
+      header._version != CapCheckpointHeader::VERSION ||
+      header._size > AffineSpace::MAXIMUM_CAP_SIZE ||
+      header._next_class > header._number_of_classes) {
+    return false;
+  }
+  // the counts in a corrupt header can be arbitrarily large: they should
+  // match the number of records that is actually in the file before we
+  // allocate memory for them
+  const std::streampos records_begin = file.tellg();
+  file.seekg(0, std::ios::end);
+  const uint64_t number_of_records =
+      (file.tellg() - records_begin) / (3 * sizeof(uint64_t));
+  if (!file || header._number_of_classes > number_of_records ||
+      header._number_of_next_classes !=
+          number_of_records - header._number_of_classes) {
+    return false;
+  }
+  file.seekg(records_begin);
+
+  std::vector<CapClass> classes(header._number_of_classes);
+  CapMap next_classes;
+  for (uint64_t i = 0;
+       i < header._number_of_classes + header._number_of_next_classes; ++i) {
+    uint64_t record[3];
+    if (!file.read(reinterpret_cast<char *>(record), sizeof(record))) {
+      return false;
+    }
+    const CardMask cap(record[0], record[1]);
+    if (i < header._number_of_classes) {
+      classes[i] = {cap, record[2]};
+    } else {
+      next_classes[cap] = record[2];
+    }
+  }
+
+  _size = header._size;
+  _classes.swap(classes);
+  _next_class = header._next_class;
+  _next_classes.swap(next_classes);
+  for (unsigned char size = 0; size <= AffineSpace::MAXIMUM_CAP_SIZE;
+       ++size) {
+    _classes_per_size[size] =
+        size <= _size ? header._classes_per_size[size] : 0;
+    _caps_per_size[size] = size <= _size ? header._caps_per_size[size] : 0;
+  }
+  return true;
+}
+
+/**
+ * @brief Enumerate all classes up to the given size.
+ *
+ * @param maximum_size Maximum size of the boards (at most
+ * AffineSpace::MAXIMUM_CAP_SIZE, since there are no larger set-free boards).
+ * @return True if all checkpoints were written successfully. A failure to
+ * write a checkpoint does not stop the enumeration, but means that an
+ * interrupted run cannot be resumed from where it stopped.
+ */
+bool CapEnumerator::run(unsigned char maximum_size) {
+  if (maximum_size > AffineSpace::MAXIMUM_CAP_SIZE) {
+    maximum_size = AffineSpace::MAXIMUM_CAP_SIZE;
+  }
+  const unsigned int number_of_workers = _pool.get_number_of_workers();
+  bool checkpoints_written = true;
+  while (_size < maximum_size) {
+    while (_next_class < _classes.size()) {
+      const unsigned long number_of_tasks =
+          std::min(_chunk_size, _classes.size() - _next_class);
+      // every worker collects its results in its own map, so that the
+      // workers never have to synchronize
+      std::vector<CapMap> next_classes(number_of_workers);
+      _pool.run_batch(number_of_tasks,
+                      [this, &next_classes](unsigned long task,
+                                            unsigned int worker) {
+                        extend(_classes[_next_class + task],
+                               next_classes[worker]);
+                      });
+      for (unsigned int worker = 0; worker < number_of_workers; ++worker) {
+        _next_classes.insert(next_classes[worker].begin(),
+                             next_classes[worker].end());
+      }
+      _next_class += number_of_tasks;
+      if (_next_class < _classes.size() && !write_checkpoint()) {
+        checkpoints_written = false;
+      }
+    }
+    finish_size();
+    if (!write_checkpoint()) {
+      checkpoints_written = false;
+    }
+  }
+  return checkpoints_written;
+}
+
+/**
+ * @brief Get the size of the classes that are being extended: the largest
+ * size for which all classes are known.
+ *
+ * @return Size of the classes.
+ */
+unsigned char CapEnumerator::get_size() const { return _size; }
+
+/**
+ * @brief Get the classes of size get_size().
+ *
+ * @return Classes, ordered on their canonical form.
+ */
+const std::vector<CapClass> &CapEnumerator::get_classes() const {
+  return _classes;
+}
+
+/**
+ * @brief Get the number of classes of set-free boards with the given size.
+ *
+ * @param size Size of the boards (at most get_size()).
+ * @return Number of classes.
+ */
+unsigned long CapEnumerator::get_number_of_classes(unsigned char size) const {
+  assert(size <= _size);
+  return _classes_per_size[size];
+}
+
+/**
+ * @brief Get the number of set-free boards with the given size.
+ *
+ * Boards are unordered collections of cards.
+ *
+ * @param size Size of the boards (at most get_size()).
+ * @return Number of set-free boards.
+ */
+uint64_t CapEnumerator::get_number_of_caps(unsigned char size) const {
+  assert(size <= _size);
+  return _caps_per_size[size];
+}
+
+/**
+ * @brief Get the probability that a random board with the given size does
+ * not contain a set.
+ *
+ * @param size Size of the boards (at most get_size()).
+ * @return Probability that a board does not contain a set.
+ */
+double CapEnumerator::get_probability(unsigned char size) const {
+  return static_cast<long double>(get_number_of_caps(size)) /
+         get_number_of_boards(size);
+}
+
+/**
+ * @brief Get the total number of boards with the given size.
+ *
+ * @param size Size of the boards (at most AffineSpace::MAXIMUM_CAP_SIZE).
+ * @return Number of ways to choose size cards out of all cards.
+ */
+uint64_t CapEnumerator::get_number_of_boards(unsigned char size) {
+  assert(size <= AffineSpace::MAXIMUM_CAP_SIZE);
+  // use Pascal's triangle: all intermediate values fit in 64 bits
+  uint64_t binomial[AffineSpace::MAXIMUM_CAP_SIZE + 1] = {1};
+  for (unsigned char n = 1; n <= AffineSpace::NUMBER_OF_POINTS; ++n) {
+    for (unsigned char k = std::min(n, size); k > 0; --k) {
+      binomial[k] += binomial[k - 1];
+    }
+  }
+  return binomial[size];
+}
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file CapEnumerator.hpp
+ *
+ * @brief Exact enumeration of set-free boards up to symmetry.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_CAPENUMERATOR_HPP
+#define OPENSET_CAPENUMERATOR_HPP
+
+#include "../engine/CardMask.hpp"
+#include "AffineSpace.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class WorkStealingPool;
+
+/**
+ * @brief Equivalence class of set-free boards.
+ */
+struct CapClass {
+  /*! @brief Canonical form of the boards in the class. */
+  CardMask _cap;
+
+  /*! @brief Number of affine transformations that map the canonical form
+   *  onto itself. */
+  uint64_t _number_of_automorphisms;
+};
+
+/**
+ * @brief Header at the start of a checkpoint file.
+ *
+ * The header is followed by the classes of size _size, and then by the
+ * classes of size _size + 1 that were found so far. Every class is stored as
+ * the two words of its canonical form, followed by its number of
+ * automorphisms. All values are stored in native byte order.
+ */
+struct CapCheckpointHeader {
+  /*! @brief Magic number at the start of every checkpoint ("OSCP"). */
+  static const uint32_t MAGIC = 0x5043534fu;
+
+  /*! @brief Version of the checkpoint format. */
+  static const uint16_t VERSION = 1;
+
+  /*! @brief Magic number (MAGIC). */
+  uint32_t _magic;
+
+  /*! @brief Version of the format (VERSION). */
+  uint16_t _version;
+
+  /*! @brief Size of the classes that are being extended. */
+  uint16_t _size;
+
+  /*! @brief Number of classes of size _size. */
+  uint64_t _number_of_classes;
+
+  /*! @brief Number of classes of size _size that were already extended. */
+  uint64_t _next_class;
+
+  /*! @brief Number of classes of size _size + 1 found so far. */
+  uint64_t _number_of_next_classes;
+
+  /*! @brief Number of classes for every size up to _size. */
+  uint64_t _classes_per_size[AffineSpace::MAXIMUM_CAP_SIZE + 1];
+
+  /*! @brief Number of set-free boards for every size up to _size. */
+  uint64_t _caps_per_size[AffineSpace::MAXIMUM_CAP_SIZE + 1];
+};
+
+/**
+ * @brief Exact enumeration of set-free boards up to symmetry.
+ *
+ * The enumeration proceeds one board size at a time: every set-free board of
+ * size k + 1 is obtained by adding a card to a set-free board of size k, so
+ * we extend one representative of every class of size k with every card that
+ * does not complete a set on it, and keep the distinct canonical forms of the
+ * results. The number of boards in a class follows from its number of
+ * automorphisms, so that we get exact counts of all set-free boards without
+ * ever visiting them.
+ *
+ * The classes of a given size are extended in chunks. Every chunk is
+ * distributed over the threads of a work stealing pool (the cost of
+ * extending a class varies a lot), and after every chunk, the progress is
+ * written to a checkpoint file, from which an interrupted run can be resumed.
+ */
+class CapEnumerator {
+private:
+  /**
+   * @brief Hash function for canonical forms.
+   */
+  struct CapHash {
+    /**
+     * @brief Hash the given canonical form.
+     *
+     * @param cap Canonical form.
+     * @return Hash.
+     */
+    inline size_t operator()(const CardMask &cap) const {
+      return (cap.get_word(0) ^ (cap.get_word(1) << 17)) *
+             0x9e3779b97f4a7c15ull;
+    }
+  };
+
+  /*! @brief Map from canonical forms to numbers of automorphisms. */
+  typedef std::unordered_map<CardMask, uint64_t, CapHash> CapMap;
+
+  /*! @brief Space. */
+  const AffineSpace &_space;
+
+  /*! @brief Pool that executes the extensions. */
+  WorkStealingPool &_pool;
+
+  /*! @brief Name of the checkpoint file (empty: no checkpoints). */
+  const std::string _checkpoint_filename;
+
+  /*! @brief Number of classes that is extended between two checkpoints. */
+  const unsigned long _chunk_size;
+
+  /*! @brief Size of the classes that are being extended. */
+  unsigned char _size;
+
+  /*! @brief Classes of size _size, ordered on their canonical form. */
+  std::vector<CapClass> _classes;
+
+  /*! @brief Number of classes of size _size that were already extended. */
+  unsigned long _next_class;
+
+  /*! @brief Classes of size _size + 1 found so far. */
+  CapMap _next_classes;
+
+  /*! @brief Number of classes for every size up to _size. */
+  unsigned long _classes_per_size[AffineSpace::MAXIMUM_CAP_SIZE + 1];
+
+  /*! @brief Number of set-free boards for every size up to _size. */
+  uint64_t _caps_per_size[AffineSpace::MAXIMUM_CAP_SIZE + 1];
+
+  void extend(const CapClass &cap_class, CapMap &next_classes) const;
+  void finish_size();
+  bool write_checkpoint() const;
+
+public:
+  CapEnumerator(WorkStealingPool &pool,
+                std::string checkpoint_filename = "",
+                unsigned long chunk_size = 256);
+
+  bool load_checkpoint();
+  bool run(unsigned char maximum_size = AffineSpace::MAXIMUM_CAP_SIZE);
+
+  unsigned char get_size() const;
+  const std::vector<CapClass> &get_classes() const;
+  unsigned long get_number_of_classes(unsigned char size) const;
+  uint64_t get_number_of_caps(unsigned char size) const;
+  double get_probability(unsigned char size) const;
+
+  static uint64_t get_number_of_boards(unsigned char size);
+};
+
+#endif // OPENSET_CAPENUMERATOR_HPP
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file BenchmarkRunner.hpp
+ *
+ * @brief Simple micro-benchmark harness.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_BENCHMARKRUNNER_HPP
+#define OPENSET_BENCHMARKRUNNER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Simple micro-benchmark harness.
+ *
+ * Every benchmark is a function that performs a given number of operations.
+ * The function is first called a number of times without timing (warmup),
+ * and is then timed for a number of repetitions. For every repetition, we
+ * compute the time per operation; the minimum, median and 99th percentile of
+ * these times are reported, together with the number of operations per second
+ * corresponding to the median time.
+ *
+ * Results are printed to the standard output in a human readable format, and
+ * can be written to a JSON file for automated regression tracking.
+ */
+class BenchmarkRunner {
+private:
+  /**
+   * @brief Result of a single benchmark.
+   */
+  struct BenchmarkResult {
+    /*! @brief Name of the benchmark. */
+    std::string _name;
+
+    /*! @brief Number of operations per repetition. */
+    unsigned int _operations_per_repetition;
+
+    /*! @brief Number of timed repetitions. */
+    unsigned int _repetitions;
+
+    /*! @brief Minimum time per operation (in ns). */
+    double _min;
+
+    /*! @brief Median time per operation (in ns). */
+    double _median;
+
+    /*! @brief 99th percentile of the time per operation (in ns). */
+    double _p99;
+  };
+
+  /*! @brief Number of untimed warmup repetitions. */
+  const unsigned int _warmup_repetitions;
+
+  /*! @brief Number of timed repetitions. */
+  const unsigned int _repetitions;
+
+  /*! @brief Results of all benchmarks that were run. */
+  std::vector<BenchmarkResult> _results;
+
+  /*! @brief Sink for the values returned by the benchmark functions, which
+   *  makes sure the compiler cannot optimize the benchmarked code away. */
+  volatile unsigned long _sink;
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param warmup_repetitions Number of untimed warmup repetitions.
+   * @param repetitions Number of timed repetitions.
+   */
+  inline BenchmarkRunner(unsigned int warmup_repetitions = 10,
+                         unsigned int repetitions = 100)
+      : _warmup_repetitions(warmup_repetitions), _repetitions(repetitions),
+        _sink(0) {}
+
+  /**
+   * @brief Run a benchmark.
+   *
+   * @param name Name of the benchmark.
+   * @param operations_per_repetition Number of operations performed by a
+   * single call of the benchmark function.
+   * @param function Benchmark function. Takes the number of operations to
+   * perform as single argument and returns a value that depends on the
+   * result of the operations.
+   */
+  template <typename _function_>
+  inline void run(const std::string &name,
+                  unsigned int operations_per_repetition,
+                  _function_ function) {
+    for (unsigned int i = 0; i < _warmup_repetitions; ++i) {
+      _sink += function(operations_per_repetition);
+    }
+
+    std::vector<double> times(_repetitions);
+    for (unsigned int i = 0; i < _repetitions; ++i) {
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      _sink += function(operations_per_repetition);
+      const std::chrono::steady_clock::time_point stop =
+          std::chrono::steady_clock::now();
+      times[i] =
+          std::chrono::duration<double, std::nano>(stop - start).count() /
+          operations_per_repetition;
+    }
+    std::sort(times.begin(), times.end());
+
+    BenchmarkResult result;
+    result._name = name;
+    result._operations_per_repetition = operations_per_repetition;
+    result._repetitions = _repetitions;
+    result._min = times[0];
+    result._median = times[_repetitions / 2];
+    result._p99 = times[std::min<unsigned int>(
+        _repetitions - 1, std::ceil(0.99 * _repetitions) - 1)];
+    _results.push_back(result);
+
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::fixed << std::setprecision(2) << " min: " << std::setw(12)
+              << result._min << " ns/op, median: " << std::setw(12)
+              << result._median << " ns/op, p99: " << std::setw(12)
+              << result._p99 << " ns/op, " << std::setw(12)
+              << 1.e9 / result._median << " op/s" << std::endl;
+  }
+
+  /**
+   * @brief Write the results of all benchmarks to the JSON file with the
+   * given name.
+   *
+   * @param filename Name of the output file.
+   */
+  inline void write_json(const std::string &filename) const {
+    std::ofstream file(filename);
+    file << std::setprecision(6) << "[\n";
+    for (unsigned int i = 0; i < _results.size(); ++i) {
+      const BenchmarkResult &result = _results[i];
+      file << "  {\"name\": \"" << result._name
+           << "\", \"operations_per_repetition\": "
+           << result._operations_per_repetition
+           << ", \"repetitions\": " << result._repetitions
+           << ", \"min_ns_per_op\": " << result._min
+           << ", \"median_ns_per_op\": " << result._median
+           << ", \"p99_ns_per_op\": " << result._p99
+           << ", \"operations_per_second\": " << 1.e9 / result._median << "}";
+      if (i + 1 < _results.size()) {
+        file << ",";
+      }
+      file << "\n";
+    }
+    file << "]\n";
+  }
+};
+
+#endif // OPENSET_BENCHMARKRUNNER_HPP
@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file benchAnalysisCache.cpp
+ *
+ * @brief Micro-benchmarks for board hashing and the analysis cache.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../analysis/AnalysisCache.hpp"
+#include "../analysis/BoardHash.hpp"
+#include "../engine/CardManager.hpp"
+#include "BenchmarkRunner.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Micro-benchmarks for board hashing and the analysis cache.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner;
+
+  // the opening boards of a number of games
+  const unsigned int number_of_boards = 1000;
+  std::vector<GameState> states;
+  for (unsigned int i = 0; i < number_of_boards; ++i) {
+    states.push_back(CardManager(i).get_state());
+  }
+
+  runner.run("board hash", 100000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const GameState &state = states[i % number_of_boards];
+      result += BoardHash::get_hash(state._main_deck, state._main_deck_size);
+    }
+    return result;
+  });
+  runner.run("symmetric board hash", 100000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const GameState &state = states[i % number_of_boards];
+      result += BoardHash::get_symmetric_hash(state._main_deck,
+                                              state._main_deck_size);
+    }
+    return result;
+  });
+  runner.run("board analysis", 100, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const GameState &state = states[i % number_of_boards];
+      result += AnalysisCache::analyze(state._main_deck, state._main_deck_size)
+                    ._number_of_stalls;
+    }
+    return result;
+  });
+
+  // fill the caches once, so that all lookups below are hits
+  std::remove("bench_analysis.cache");
+  std::remove("bench_symmetric_analysis.cache");
+  AnalysisCache cache("bench_analysis.cache");
+  AnalysisCache symmetric_cache("bench_symmetric_analysis.cache", 1 << 20,
+                                true);
+  for (unsigned int i = 0; i < number_of_boards; ++i) {
+    const BoardAnalysis analysis = AnalysisCache::analyze(
+        states[i]._main_deck, states[i]._main_deck_size);
+    cache.insert(states[i]._main_deck, states[i]._main_deck_size, analysis);
+    symmetric_cache.insert(states[i]._main_deck, states[i]._main_deck_size,
+                           analysis);
+  }
+  runner.run("cache hit", 100000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const GameState &state = states[i % number_of_boards];
+      result += cache.get_analysis(state._main_deck, state._main_deck_size)
+                    ._number_of_stalls;
+    }
+    return result;
+  });
+  runner.run("symmetric cache hit", 100000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const GameState &state = states[i % number_of_boards];
+      result += symmetric_cache
+                    .get_analysis(state._main_deck, state._main_deck_size)
+                    ._number_of_stalls;
+    }
+    return result;
+  });
+  std::cout << "  cache misses: " << cache.get_number_of_misses()
+            << ", symmetric cache misses: "
+            << symmetric_cache.get_number_of_misses() << std::endl;
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file benchBot.cpp
+ *
+ * @brief Micro-benchmarks for the bots.
+ *
+ * Usage: benchBot [JSON OUTPUT FILE]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../bots/HumanBot.hpp"
+#include "../bots/InstantBot.hpp"
+#include "../bots/LookaheadBot.hpp"
+#include "BenchmarkRunner.hpp"
+
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Let the given bot play a complete game.
+ *
+ * @param bot Bot.
+ * @param seed Seed of the game.
+ * @param number_of_expanded_boards Number of moves that left more than
+ * BASE_BOARD_SIZE cards on the main deck (updated).
+ * @return Number of sets that was taken.
+ */
+static unsigned long play_game(Bot &bot, uint64_t seed,
+                               unsigned long &number_of_expanded_boards) {
+  CardManager card_manager(seed);
+  BotMove move;
+  unsigned long number_of_sets = 0;
+  while (bot.find_move(card_manager, move)) {
+    Bot::play_move(card_manager, move);
+    if (card_manager.get_board().size() > CardManager::BASE_BOARD_SIZE) {
+      ++number_of_expanded_boards;
+    }
+    ++number_of_sets;
+  }
+  return number_of_sets;
+}
+
+/**
+ * @brief Micro-benchmarks for the bots.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner;
+
+  // a single decision on a fixed board
+  CardManager card_manager(42);
+  InstantBot instant_bot;
+  HumanBot human_bot(42);
+  LookaheadBot lookahead_bot;
+  BotMove move;
+  runner.run("instant bot move", 100000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      result += instant_bot.find_move(card_manager, move);
+    }
+    return result;
+  });
+  runner.run("human bot move", 100000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      result += human_bot.find_move(card_manager, move);
+    }
+    return result;
+  });
+  runner.run("lookahead bot move", 10000, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      result += lookahead_bot.find_move(card_manager, move);
+    }
+    return result;
+  });
+
+  // many bots playing at the same time, every bot in its own game
+  const unsigned int number_of_bots = 1000;
+  std::vector<HumanBot> human_bots;
+  for (unsigned int i = 0; i < number_of_bots; ++i) {
+    human_bots.push_back(HumanBot(i));
+  }
+  uint64_t seed = 0;
+  unsigned long number_of_expanded_boards = 0;
+  runner.run("1000 human bots, full games", 1, [&](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int j = 0; j < number_of_bots; ++j) {
+        result +=
+            play_game(human_bots[j], ++seed, number_of_expanded_boards);
+      }
+    }
+    return result;
+  });
+  std::cout << "  size of a human bot: " << sizeof(HumanBot) << " bytes"
+            << std::endl;
+
+  // strategy comparison: how often does the board run out of sets?
+  const unsigned long number_of_games = 10000;
+  unsigned long instant_expanded_boards = 0;
+  unsigned long lookahead_expanded_boards = 0;
+  for (uint64_t i = 0; i < number_of_games; ++i) {
+    play_game(instant_bot, i, instant_expanded_boards);
+    play_game(lookahead_bot, i, lookahead_expanded_boards);
+  }
+  std::cout << "  expanded boards per game: instant bot "
+            << double(instant_expanded_boards) / number_of_games
+            << ", lookahead bot "
+            << double(lookahead_expanded_boards) / number_of_games
+            << std::endl;
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file benchCardManager.cpp
+ *
+ * @brief Micro-benchmarks for the CardManager hot paths.
+ *
+ * Usage: benchCardManager [JSON OUTPUT FILE]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/CardManager.hpp"
+#include "BenchmarkRunner.hpp"
+
+#include <vector>
+
+/**
+ * @brief Micro-benchmarks for the CardManager hot paths.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner;
+
+  // construction: creates the cards, shuffles them and deals the main deck
+  uint64_t seed = 0;
+  runner.run("CardManager construction", 1000, [&seed](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      CardManager card_manager(++seed);
+      result += card_manager.get_card(0).get_index();
+    }
+    return result;
+  });
+
+  // is_set on a fixed pseudo-random sequence of card triples
+  std::vector<Card> cards;
+  for (unsigned int i = 0; i < 3 * 1024; ++i) {
+    cards.push_back(Card((i * 37 + i / 81) % CardIndex::CARDINDEX_COUNTER));
+  }
+  runner.run("CardManager::is_set", 100000, [&cards](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const unsigned int j = 3 * (i & 1023);
+      result += CardManager::is_set(cards[j], cards[j + 1], cards[j + 2]);
+    }
+    return result;
+  });
+
+  // clicking a card and clicking it again (unclick)
+  CardManager card_manager(42);
+  runner.run("click_card (click + unclick)", 100000,
+             [&card_manager](unsigned int n) {
+               unsigned long result = 0;
+               for (unsigned int i = 0; i < n; ++i) {
+                 const unsigned char index = i % 12;
+                 card_manager.click_card(index);
+                 result += card_manager.is_clicked(index);
+                 card_manager.click_card(index);
+               }
+               return result;
+             });
+
+  // clicking three cards that do not make up a set: check_set rejects them
+  unsigned char no_set[3] = {0, 1, 2};
+  while (CardManager::is_set(card_manager.get_board()[no_set[0]],
+                             card_manager.get_board()[no_set[1]],
+                             card_manager.get_board()[no_set[2]])) {
+    ++no_set[2];
+  }
+  runner.run("click_card + check_set (no set)", 100000,
+             [&card_manager, &no_set](unsigned int n) {
+               unsigned long result = 0;
+               for (unsigned int i = 0; i < n; ++i) {
+                 card_manager.click_card(no_set[0]);
+                 card_manager.click_card(no_set[1]);
+                 card_manager.click_card(no_set[2]);
+                 result += card_manager.is_clicked(no_set[2]);
+               }
+               return result;
+             });
+
+  // playing complete games: every move consists of three clicks on a set that
+  // was found using find_all_sets(), followed by check_set()
+  seed = 0;
+  runner.run("full game (find_all_sets + clicks)", 100,
+             [&seed](unsigned int n) {
+               unsigned long result = 0;
+               unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+               for (unsigned int i = 0; i < n; ++i) {
+                 CardManager game(++seed);
+                 while (game.find_all_sets(sets) > 0) {
+                   game.click_card(sets[0]);
+                   game.click_card(sets[1]);
+                   game.click_card(sets[2]);
+                   ++result;
+                 }
+               }
+               return result;
+             });
+
+  // snapshot and restore the state of a game
+  runner.run("snapshot + restore", 100000, [&card_manager](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      const GameState state = card_manager.snapshot();
+      card_manager.restore(state);
+      result += state._next_card;
+    }
+    return result;
+  });
+
+  // fork a game and take a set in the fork: a single step in a tree search
+  unsigned char fork_set[3 * CardManager::MAX_NUMBER_OF_SETS];
+  card_manager.find_all_sets(fork_set);
+  runner.run("fork + take set", 100000,
+             [&card_manager, &fork_set](unsigned int n) {
+               unsigned long result = 0;
+               for (unsigned int i = 0; i < n; ++i) {
+                 CardManager fork = card_manager.fork();
+                 fork.click_card(fork_set[0]);
+                 fork.click_card(fork_set[1]);
+                 result += fork.click_card(fork_set[2]);
+               }
+               return result;
+             });
+
+  // find_all_sets on the main deck
+  runner.run("find_all_sets", 100000, [&card_manager](unsigned int n) {
+    unsigned long result = 0;
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    for (unsigned int i = 0; i < n; ++i) {
+      result += card_manager.find_all_sets(sets);
+    }
+    return result;
+  });
+
+  // counting the sets on the main deck from scratch
+  runner.run("count_sets (board scan)", 100000,
+             [&card_manager](unsigned int n) {
+               unsigned long result = 0;
+               IndexSpan board = card_manager.get_board_indices();
+               for (unsigned int i = 0; i < n; ++i) {
+                 result += CardManager::count_sets(board.begin(), board.size());
+               }
+               return result;
+             });
+
+  // the same number, taken from the set index
+  runner.run("set_count (set index)", 100000,
+             [&card_manager](unsigned int n) {
+               unsigned long result = 0;
+               for (unsigned int i = 0; i < n; ++i) {
+                 result += card_manager.set_count();
+               }
+               return result;
+             });
+
+  // get_deck: copies the main deck
+  runner.run("get_deck", 100000, [&card_manager](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      std::vector<Card> deck = card_manager.get_deck();
+      for (unsigned char card = 0; card < deck.size(); ++card) {
+        result += deck[card].get_number_of_symbols();
+      }
+    }
+    return result;
+  });
+
+  // get_board: iterates over the main deck without copying it
+  runner.run("get_board", 100000, [&card_manager](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      for (const Card &card : card_manager.get_board()) {
+        result += card.get_number_of_symbols();
+      }
+    }
+    return result;
+  });
+
+  // get_board_indices: raw card indices on the main deck
+  runner.run("get_board_indices", 100000, [&card_manager](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned char index : card_manager.get_board_indices()) {
+        result += index;
+      }
+    }
+    return result;
+  });
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
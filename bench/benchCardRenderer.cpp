@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file benchCardRenderer.cpp
+ *
+ * @brief Benchmark for the headless card renderer.
+ *
+ * Renders cards to an offscreen image surface at several resolutions; the
+ * number of operations per second is the number of cards rendered per second.
+ *
+ * Usage: benchCardRenderer [JSON OUTPUT FILE]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/Card.hpp"
+#include "../visuals/CardRenderer.hpp"
+#include "BenchmarkRunner.hpp"
+
+#include <sstream>
+
+/**
+ * @brief Benchmark for the headless card renderer.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner(2, 20);
+  CardRenderer renderer;
+
+  // card sizes (in pixels): cards have an aspect ratio of 1/sqrt(2)
+  const int sizes[4][2] = {{64, 90}, {128, 181}, {256, 362}, {512, 724}};
+  for (unsigned int isize = 0; isize < 4; ++isize) {
+    const int width = sizes[isize][0];
+    const int height = sizes[isize][1];
+    cairo_surface_t *surface =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t *cr = cairo_create(surface);
+
+    std::stringstream name;
+    name << "render card " << width << "x" << height;
+    unsigned char index = 0;
+    runner.run(name.str(), 162,
+               [&renderer, &index, cr, width, height](unsigned int n) {
+                 for (unsigned int i = 0; i < n; ++i) {
+                   // clear the surface
+                   cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+                   cairo_paint(cr);
+                   cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+                   // draw every card, clicked and unclicked
+                   renderer.draw_card(cr, Card::get_card(index), i & 1, width,
+                                      height);
+                   index = (index + 1) % CardIndex::CARDINDEX_COUNTER;
+                 }
+                 cairo_surface_flush(cairo_get_target(cr));
+                 return static_cast<unsigned long>(index);
+               });
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file benchGameEngine.cpp
+ *
+ * @brief Micro-benchmarks for the engine thread and its queues.
+ *
+ * Usage: benchGameEngine [JSON OUTPUT FILE]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/GameEngine.hpp"
+#include "BenchmarkRunner.hpp"
+
+#include <iostream>
+
+/**
+ * @brief Micro-benchmarks for the engine thread and its queues.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner;
+
+  // a push immediately followed by a pop on the same thread
+  SPSCQueue<EngineCommand, GameEngine::COMMAND_QUEUE_SIZE> queue;
+  runner.run("queue push + pop", 100000, [&queue](unsigned int n) {
+    EngineCommand command;
+    command._type = ENGINECOMMAND_CLICK;
+    command._time = 0;
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      command._data = i;
+      queue.try_push(command);
+      queue.try_pop(command);
+      result += command._data;
+    }
+    return result;
+  });
+
+  // a click and its notification: includes waking up the engine thread
+  CardManager card_manager(42);
+  GameEngine engine(card_manager);
+  runner.run("click round trip", 10000, [&engine](unsigned int n) {
+    EngineNotification notification;
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      // clicking the same card twice leaves the board unchanged
+      engine.click_card(0);
+      while (!engine.pop_notification(notification)) {
+      }
+      result += notification._dirty;
+    }
+    return result;
+  });
+  std::cout << "  average command latency: "
+            << engine.get_average_command_latency() << " ns, max: "
+            << engine.get_max_command_latency() << " ns\n";
+  std::cout << "  average round trip latency: "
+            << engine.get_average_round_trip_latency() << " ns, max: "
+            << engine.get_max_round_trip_latency() << " ns" << std::endl;
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file benchGameLog.cpp
+ *
+ * @brief Micro-benchmarks for recording and replaying binary game logs.
+ *
+ * Usage: benchGameLog [JSON OUTPUT FILE]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/CardManager.hpp"
+#include "../engine/GameLogReader.hpp"
+#include "../engine/GameLogWriter.hpp"
+#include "BenchmarkRunner.hpp"
+
+/**
+ * @brief Play a complete game, taking the first set that is found every time.
+ *
+ * @param card_manager CardManager to play with.
+ * @return Number of sets that was taken.
+ */
+static unsigned long play_game(CardManager &card_manager) {
+  unsigned long number_of_sets = 0;
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  while (card_manager.find_all_sets(sets) > 0) {
+    card_manager.click_card(sets[0]);
+    card_manager.click_card(sets[1]);
+    card_manager.click_card(sets[2]);
+    ++number_of_sets;
+  }
+  return number_of_sets;
+}
+
+/**
+ * @brief Micro-benchmarks for recording and replaying binary game logs.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner;
+
+  // playing complete games with and without recording them
+  uint64_t seed = 0;
+  runner.run("full game (not recorded)", 100, [&seed](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      CardManager card_manager(++seed);
+      result += play_game(card_manager);
+    }
+    return result;
+  });
+  seed = 0;
+  runner.run("full game (recorded to file)", 100, [&seed](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      CardManager card_manager(++seed);
+      GameLogWriter writer("bench_game_log.bin");
+      card_manager.set_recorder(&writer);
+      result += play_game(card_manager);
+      card_manager.set_recorder(NULL);
+    }
+    return result;
+  });
+
+  // replaying a recorded game: time per event
+  {
+    CardManager card_manager(42);
+    GameLogWriter writer("bench_game_log.bin", 16);
+    card_manager.set_recorder(&writer);
+    play_game(card_manager);
+    card_manager.set_recorder(NULL);
+    writer.close();
+  }
+  GameLogReader reader("bench_game_log.bin");
+  CardManager replay_manager;
+  unsigned long number_of_events = 0;
+  if (!reader.replay(replay_manager, &number_of_events)) {
+    std::cerr << "Replay of the recorded game failed!" << std::endl;
+    return 1;
+  }
+  runner.run("replay (per event)", number_of_events,
+             [&reader, &replay_manager](unsigned int n) {
+               unsigned long result = 0;
+               // every replay processes the n events in the log
+               result += reader.replay(replay_manager);
+               return result;
+             });
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
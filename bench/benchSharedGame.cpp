@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file benchSharedGame.cpp
+ *
+ * @brief Micro-benchmarks for concurrent set claiming.
+ *
+ * Usage: benchSharedGame [JSON OUTPUT FILE]
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/SharedGame.hpp"
+#include "BenchmarkRunner.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Player thread: keeps claiming a set until the game is finished.
+ *
+ * @param game SharedGame.
+ * @param player Index of the player.
+ * @param claims Number of claims this player made.
+ */
+static void play(SharedGame &game, unsigned int player,
+                 unsigned long &claims) {
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  while (true) {
+    const SharedBoard board = game.read();
+    const unsigned char number_of_sets = CardManager::find_all_sets(
+        board._main_deck, board._main_deck_size, sets);
+    if (number_of_sets == 0) {
+      return;
+    }
+    game.claim(board, sets + 3 * (player % number_of_sets));
+    ++claims;
+  }
+}
+
+/**
+ * @brief Micro-benchmarks for concurrent set claiming.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  BenchmarkRunner runner;
+
+  // uncontended operations
+  SharedGame game(42);
+  runner.run("read", 100000, [&game](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      result += game.read()._main_deck_size;
+    }
+    return result;
+  });
+  const SharedBoard stale_board = game.read();
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  CardManager::find_all_sets(stale_board._main_deck,
+                             stale_board._main_deck_size, sets);
+  game.claim(stale_board, sets);
+  runner.run("stale claim", 100000, [&game, &stale_board,
+                                     &sets](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      result += game.claim(stale_board, sets);
+    }
+    return result;
+  });
+  uint64_t seed = 0;
+  runner.run("full game (1 player)", 100, [&seed](unsigned int n) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      SharedGame game(++seed);
+      play(game, 0, result);
+    }
+    return result;
+  });
+
+  // contended games: the time per operation is the time per game, the number
+  // of claims per second is printed separately
+  for (unsigned int number_of_players = 2; number_of_players <= 32;
+       number_of_players *= 4) {
+    unsigned long total_claims = 0;
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    runner.run("full game (" + std::to_string(number_of_players) +
+                   " players)",
+               10, [&seed, number_of_players, &total_claims](unsigned int n) {
+                 for (unsigned int i = 0; i < n; ++i) {
+                   SharedGame game(++seed);
+                   std::vector<unsigned long> claims(number_of_players, 0);
+                   std::vector<std::thread> players;
+                   for (unsigned int j = 0; j < number_of_players; ++j) {
+                     players.push_back(std::thread(play, std::ref(game), j,
+                                                   std::ref(claims[j])));
+                   }
+                   for (unsigned int j = 0; j < number_of_players; ++j) {
+                     players[j].join();
+                     total_claims += claims[j];
+                   }
+                 }
+                 return total_claims;
+               });
+    const std::chrono::steady_clock::time_point stop =
+        std::chrono::steady_clock::now();
+    std::cout << "  claims/s (" << number_of_players << " players): "
+              << total_claims / std::chrono::duration<double>(stop - start)
+                                    .count()
+              << std::endl;
+  }
+
+  if (argc > 1) {
+    runner.write_json(argv[1]);
+  }
+
+  return 0;
+}
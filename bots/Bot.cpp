@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file Bot.cpp
+ *
+ * @brief Bot implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "Bot.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Find the positions of the given cards on the main deck.
+ *
+ * @param card_manager Game.
+ * @param cards Indices of three cards on the main deck.
+ * @param positions Array to store the positions in (in increasing order).
+ */
+void Bot::get_positions(const CardManager &card_manager,
+                        const unsigned char *cards, unsigned char *positions) {
+  const IndexSpan board = card_manager.get_board_indices();
+  unsigned char number_of_positions = 0;
+  for (unsigned char i = 0; i < board.size() && number_of_positions < 3; ++i) {
+    if (board[i] == cards[0] || board[i] == cards[1] || board[i] == cards[2]) {
+      positions[number_of_positions] = i;
+      ++number_of_positions;
+    }
+  }
+  assert(number_of_positions == 3);
+}
+
+/**
+ * @brief Play the given move.
+ *
+ * The selection of the game should be empty.
+ *
+ * @param card_manager Game.
+ * @param move Move chosen by a bot for the current main deck.
+ * @return Dirty mask of the main deck (see CardManager::click_card()).
+ */
+uint32_t Bot::play_move(CardManager &card_manager, const BotMove &move) {
+  uint32_t dirty = card_manager.click_card(move._positions[0]);
+  dirty |= card_manager.click_card(move._positions[1]);
+  dirty |= card_manager.click_card(move._positions[2]);
+  return dirty;
+}
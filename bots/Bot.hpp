@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file Bot.hpp
+ *
+ * @brief General interface for programmatic players.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_BOT_HPP
+#define OPENSET_BOT_HPP
+
+#include "../engine/CardManager.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Move chosen by a bot.
+ */
+struct BotMove {
+  /*! @brief Positions of the three cards of the set on the main deck (in
+   *  increasing order). */
+  unsigned char _positions[3];
+
+  /*! @brief Time the bot waits before it plays the move (simulated reaction
+   *  time, not spent by find_move()). */
+  std::chrono::nanoseconds _delay;
+};
+
+/**
+ * @brief General interface for programmatic players.
+ *
+ * A bot looks at a game and chooses a set to take, within a fixed time budget
+ * per move. How the budget is used depends on the bot: only LookaheadBot
+ * searches for a better move and measures the time it spends using the
+ * monotonic steady clock. HumanBot compares the budget with its simulated
+ * search time, and InstantBot does a constant time lookup that never gets
+ * close to its budget, so neither of them measures time. Bots never sleep and
+ * do not own threads: a simulated reaction time is returned as part of the
+ * move, so that the caller can schedule the move. A bot only stores a few
+ * bytes of state, so that thousands of bots can play at the same time.
+ */
+class Bot {
+protected:
+  /*! @brief Maximum time find_move() can take. */
+  const std::chrono::nanoseconds _budget;
+
+  static void get_positions(const CardManager &card_manager,
+                            const unsigned char *cards,
+                            unsigned char *positions);
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param budget Maximum time find_move() can take.
+   */
+  inline Bot(std::chrono::nanoseconds budget) : _budget(budget) {}
+
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~Bot() {}
+
+  /**
+   * @brief Get the time budget per move.
+   *
+   * @return Maximum time find_move() can take.
+   */
+  inline std::chrono::nanoseconds get_budget() const { return _budget; }
+
+  /**
+   * @brief Choose a set on the main deck of the given game.
+   *
+   * @param card_manager Game.
+   * @param move Variable to store the chosen move in.
+   * @return True if a move was chosen, false if the bot found no set within
+   * its (measured or simulated) time budget, or the main deck does not
+   * contain a set.
+   */
+  virtual bool find_move(const CardManager &card_manager, BotMove &move) = 0;
+
+  static uint32_t play_move(CardManager &card_manager, const BotMove &move);
+};
+
+#endif // OPENSET_BOT_HPP
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file HumanBot.cpp
+ *
+ * @brief HumanBot implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "HumanBot.hpp"
+
+#include <cmath>
+
+/**
+ * @brief Constructor.
+ *
+ * @param seed Seed for the random generator.
+ * @param budget Maximum time the bot can spend on a move (including the
+ * simulated delay).
+ * @param reaction_time Fixed reaction time.
+ * @param card_time Mean time needed to look at a single card.
+ */
+HumanBot::HumanBot(uint64_t seed, std::chrono::nanoseconds budget,
+                   std::chrono::nanoseconds reaction_time,
+                   std::chrono::nanoseconds card_time)
+    : Bot(budget), _random_generator(seed), _reaction_time(reaction_time),
+      _card_time(card_time) {}
+
+/**
+ * @brief Choose a random set and the time it takes to find it.
+ *
+ * @param card_manager Game.
+ * @param move Variable to store the chosen move in.
+ * @return True if the simulated delay does not exceed the time budget.
+ */
+bool HumanBot::find_move(const CardManager &card_manager, BotMove &move) {
+  const SetIndex &sets = card_manager.get_sets();
+  const unsigned char number_of_sets = sets.set_count();
+  if (number_of_sets == 0) {
+    return false;
+  }
+
+  // the mean search time is the time needed to look at all cards, divided by
+  // the number of sets that can be found
+  const double mean_search_time = double(_card_time.count()) *
+                                  card_manager.get_board().size() /
+                                  number_of_sets;
+  // uniform random number in ]0, 1]
+  const double uniform =
+      (_random_generator.get_random_integer() + 1.) / 4294967296.;
+  const std::chrono::nanoseconds delay =
+      _reaction_time + std::chrono::nanoseconds(static_cast<int64_t>(
+                           -mean_search_time * std::log(uniform)));
+  if (delay > _budget) {
+    return false;
+  }
+
+  get_positions(card_manager,
+                sets.get_set(_random_generator.get_random_integer(
+                    number_of_sets)),
+                move._positions);
+  move._delay = delay;
+  return true;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file HumanBot.hpp
+ *
+ * @brief Bot that mimics the reaction time of a human player.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_HUMANBOT_HPP
+#define OPENSET_HUMANBOT_HPP
+
+#include "../engine/RandomGenerator.hpp"
+#include "Bot.hpp"
+
+/**
+ * @brief Bot that mimics the reaction time of a human player.
+ *
+ * A human needs a fixed reaction time to take a set, plus the time it takes to
+ * spot one. The latter is drawn from an exponential distribution whose mean
+ * grows with the number of cards on the main deck and shrinks with the number
+ * of sets on it. The bot takes a random set. If the resulting delay exceeds
+ * the time budget, the bot gives up and does not move, like a player that
+ * runs out of time. The budget is compared with this simulated delay, not
+ * with the time find_move() actually takes.
+ *
+ * The delay is only returned, never waited for, and the bot is seeded, so
+ * that games with human bots are reproducible and can be simulated faster
+ * than real time.
+ */
+class HumanBot : public Bot {
+private:
+  /*! @brief Random generator used for the search times and set choice. */
+  RandomGenerator _random_generator;
+
+  /*! @brief Fixed reaction time. */
+  const std::chrono::nanoseconds _reaction_time;
+
+  /*! @brief Mean time needed to look at a single card. */
+  const std::chrono::nanoseconds _card_time;
+
+public:
+  HumanBot(uint64_t seed,
+           std::chrono::nanoseconds budget = std::chrono::seconds(30),
+           std::chrono::nanoseconds reaction_time =
+               std::chrono::milliseconds(500),
+           std::chrono::nanoseconds card_time =
+               std::chrono::milliseconds(400));
+
+  virtual bool find_move(const CardManager &card_manager, BotMove &move);
+};
+
+#endif // OPENSET_HUMANBOT_HPP
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file InstantBot.cpp
+ *
+ * @brief InstantBot implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "InstantBot.hpp"
+
+/**
+ * @brief Constructor.
+ *
+ * @param budget Maximum time find_move() can take.
+ */
+InstantBot::InstantBot(std::chrono::nanoseconds budget) : Bot(budget) {}
+
+/**
+ * @brief Choose the first set in the set index of the game.
+ *
+ * @param card_manager Game.
+ * @param move Variable to store the chosen move in.
+ * @return True if the main deck contains a set.
+ */
+bool InstantBot::find_move(const CardManager &card_manager, BotMove &move) {
+  const SetIndex &sets = card_manager.get_sets();
+  if (sets.set_count() == 0) {
+    return false;
+  }
+  get_positions(card_manager, sets.get_set(0), move._positions);
+  move._delay = std::chrono::nanoseconds(0);
+  return true;
+}
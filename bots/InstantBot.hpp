@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file InstantBot.hpp
+ *
+ * @brief Bot that immediately takes the first set it finds.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_INSTANTBOT_HPP
+#define OPENSET_INSTANTBOT_HPP
+
+#include "Bot.hpp"
+
+/**
+ * @brief Bot that immediately takes the first set it finds.
+ *
+ * This is the fastest possible player: it never misses a set and has no
+ * reaction time. Finding a set is a constant time lookup in the set index of
+ * the game, so the time budget is never exceeded.
+ */
+class InstantBot : public Bot {
+public:
+  InstantBot(std::chrono::nanoseconds budget = std::chrono::milliseconds(1));
+
+  virtual bool find_move(const CardManager &card_manager, BotMove &move);
+};
+
+#endif // OPENSET_INSTANTBOT_HPP
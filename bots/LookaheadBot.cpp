@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file LookaheadBot.cpp
+ *
+ * @brief LookaheadBot implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "LookaheadBot.hpp"
+
+/**
+ * @brief Constructor.
+ *
+ * @param budget Maximum time find_move() can take.
+ */
+LookaheadBot::LookaheadBot(std::chrono::nanoseconds budget) : Bot(budget) {}
+
+/**
+ * @brief Count the sets that are left on the main deck after the given set is
+ * taken.
+ *
+ * @param board Card indices on the main deck.
+ * @param set Card indices of a set on the main deck.
+ * @return Number of sets among the remaining cards.
+ */
+unsigned char LookaheadBot::evaluate(const IndexSpan &board,
+                                     const unsigned char *set) {
+  unsigned char remaining[CardManager::MAX_BOARD_SIZE];
+  unsigned char number_of_remaining = 0;
+  for (unsigned char i = 0; i < board.size(); ++i) {
+    if (board[i] != set[0] && board[i] != set[1] && board[i] != set[2]) {
+      remaining[number_of_remaining] = board[i];
+      ++number_of_remaining;
+    }
+  }
+  return CardManager::count_sets(remaining, number_of_remaining);
+}
+
+/**
+ * @brief Choose the set that leaves the most sets on the main deck.
+ *
+ * @param card_manager Game.
+ * @param move Variable to store the chosen move in.
+ * @return True if the main deck contains a set.
+ */
+bool LookaheadBot::find_move(const CardManager &card_manager, BotMove &move) {
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + _budget;
+  const SetIndex &sets = card_manager.get_sets();
+  const unsigned char number_of_sets = sets.set_count();
+  if (number_of_sets == 0) {
+    return false;
+  }
+
+  // the first set is the fallback if the budget runs out immediately
+  unsigned char best_set = 0;
+  int best_score = -1;
+  const IndexSpan board = card_manager.get_board_indices();
+  for (unsigned char i = 0; i < number_of_sets; ++i) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    const int score = evaluate(board, sets.get_set(i));
+    if (score > best_score) {
+      best_set = i;
+      best_score = score;
+    }
+  }
+
+  get_positions(card_manager, sets.get_set(best_set), move._positions);
+  move._delay = std::chrono::nanoseconds(0);
+  return true;
+}
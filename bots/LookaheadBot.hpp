@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file LookaheadBot.hpp
+ *
+ * @brief Bot that prefers sets that leave the main deck in a good state.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_LOOKAHEADBOT_HPP
+#define OPENSET_LOOKAHEADBOT_HPP
+
+#include "Bot.hpp"
+
+/**
+ * @brief Bot that prefers sets that leave the main deck in a good state.
+ *
+ * For every set on the main deck, the bot counts the sets among the cards
+ * that stay on the main deck after taking it, and takes the set that leaves
+ * the most sets behind: this keeps the main deck from running out of sets, so
+ * that fewer extra cards need to be dealt. Only cards that are visible on the
+ * main deck are used: the bot does not peek at the card stack.
+ *
+ * The candidates are evaluated until the time budget runs out, after which
+ * the best set so far is taken.
+ */
+class LookaheadBot : public Bot {
+public:
+  LookaheadBot(std::chrono::nanoseconds budget = std::chrono::microseconds(50));
+
+  virtual bool find_move(const CardManager &card_manager, BotMove &move);
+
+  static unsigned char evaluate(const IndexSpan &board,
+                                const unsigned char *set);
+};
+
+#endif // OPENSET_LOOKAHEADBOT_HPP
@@ -0,0 +1,201 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file BoardView.hpp
+ *
+ * @brief Lightweight non-owning views on the cards on the main deck.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_BOARDVIEW_HPP
+#define OPENSET_BOARDVIEW_HPP
+
+#include "Card.hpp"
+
+/**
+ * @brief Non-owning view on a contiguous range of card indices.
+ */
+class IndexSpan {
+private:
+  /*! @brief Pointer to the first card index. */
+  const unsigned char *_indices;
+
+  /*! @brief Number of card indices. */
+  unsigned char _size;
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param indices Pointer to the first card index.
+   * @param size Number of card indices.
+   */
+  inline IndexSpan(const unsigned char *indices, unsigned char size)
+      : _indices(indices), _size(size) {}
+
+  /**
+   * @brief Get the number of card indices in the span.
+   *
+   * @return Number of card indices.
+   */
+  inline unsigned char size() const { return _size; }
+
+  /**
+   * @brief Get the card index at the given position.
+   *
+   * @param position Position in the span.
+   * @return Card index.
+   */
+  inline unsigned char operator[](unsigned char position) const {
+    return _indices[position];
+  }
+
+  /**
+   * @brief Get a pointer to the first card index.
+   *
+   * @return Pointer to the first card index.
+   */
+  inline const unsigned char *begin() const { return _indices; }
+
+  /**
+   * @brief Get a pointer past the last card index.
+   *
+   * @return Pointer past the last card index.
+   */
+  inline const unsigned char *end() const { return _indices + _size; }
+};
+
+/**
+ * @brief Non-owning view on the cards on the main deck.
+ *
+ * The view does not copy any cards: the cards are looked up in the shared
+ * card table (see Card::get_card()) when they are accessed. The view is only
+ * valid as long as the main deck is not changed.
+ */
+class BoardView {
+public:
+  /**
+   * @brief Iterator over the cards in the view.
+   */
+  class iterator {
+  private:
+    /*! @brief Pointer to the current card index. */
+    const unsigned char *_index;
+
+  public:
+    /**
+     * @brief Constructor.
+     *
+     * @param index Pointer to the current card index.
+     */
+    inline iterator(const unsigned char *index) : _index(index) {}
+
+    /**
+     * @brief Dereference operator.
+     *
+     * @return Constant reference to the current card.
+     */
+    inline const Card &operator*() const { return Card::get_card(*_index); }
+
+    /**
+     * @brief Increment operator.
+     *
+     * @return Reference to the incremented iterator.
+     */
+    inline iterator &operator++() {
+      ++_index;
+      return *this;
+    }
+
+    /**
+     * @brief Compare two iterators.
+     *
+     * @param it Other iterator.
+     * @return True if both iterators point to a different card.
+     */
+    inline bool operator!=(const iterator &it) const {
+      return _index != it._index;
+    }
+
+    /**
+     * @brief Compare two iterators.
+     *
+     * @param it Other iterator.
+     * @return True if both iterators point to the same card.
+     */
+    inline bool operator==(const iterator &it) const {
+      return _index == it._index;
+    }
+  };
+
+private:
+  /*! @brief Indices of the cards in the view. */
+  IndexSpan _indices;
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param indices Pointer to the first card index.
+   * @param size Number of cards.
+   */
+  inline BoardView(const unsigned char *indices, unsigned char size)
+      : _indices(indices, size) {}
+
+  /**
+   * @brief Get the number of cards in the view.
+   *
+   * @return Number of cards.
+   */
+  inline unsigned char size() const { return _indices.size(); }
+
+  /**
+   * @brief Get the card at the given position.
+   *
+   * @param position Position in the view.
+   * @return Constant reference to the card.
+   */
+  inline const Card &operator[](unsigned char position) const {
+    return Card::get_card(_indices[position]);
+  }
+
+  /**
+   * @brief Get an iterator to the first card in the view.
+   *
+   * @return Iterator to the first card.
+   */
+  inline iterator begin() const { return iterator(_indices.begin()); }
+
+  /**
+   * @brief Get an iterator past the last card in the view.
+   *
+   * @return Iterator past the last card.
+   */
+  inline iterator end() const { return iterator(_indices.end()); }
+
+  /**
+   * @brief Get the indices of the cards in the view.
+   *
+   * @return IndexSpan containing the card indices.
+   */
+  inline const IndexSpan &get_indices() const { return _indices; }
+};
+
+#endif // OPENSET_BOARDVIEW_HPP
@@ -27,12 +27,39 @@
 #include "Card.hpp"
 
 /**
- * @brief Empty constructor.
+ * @brief Table containing all cards in the game.
+ *
+ * The table is fully computed at compile time.
  */
-Card::Card()
-    : _number_of_symbols(0), _colour(CardProperties::CARDCOLOUR_COUNTER),
-      _symbol(CardProperties::CARDSYMBOL_COUNTER),
-      _fill(CardProperties::CARDFILL_COUNTER), _clicked(false) {}
+class CardTable {
+private:
+  /*! @brief Cards. */
+  Card _cards[CardIndex::CARDINDEX_COUNTER];
+
+public:
+  /**
+   * @brief Constructor.
+   */
+  constexpr CardTable() : _cards{} {
+    for (unsigned char index = 0; index < CardIndex::CARDINDEX_COUNTER;
+         ++index) {
+      _cards[index] = Card(index);
+    }
+  }
+
+  /**
+   * @brief Get the card with the given index.
+   *
+   * @param index Index of a card.
+   * @return Constant reference to the card.
+   */
+  constexpr const Card &get_card(unsigned char index) const {
+    return _cards[index];
+  }
+};
+
+/*! @brief Table containing all cards in the game. */
+static constexpr CardTable CARD_TABLE;
 
 /**
  * @brief Constructor.
@@ -46,50 +73,58 @@ Card::Card()
  */
 Card::Card(unsigned char number_of_symbols, CardProperties::CardColour colour,
            CardProperties::CardSymbol symbol, CardProperties::CardFill fill)
-    : _number_of_symbols(number_of_symbols), _colour(colour), _symbol(symbol),
-      _fill(fill), _clicked(false) {}
+    : _index(CardIndex::get_index(number_of_symbols, colour, symbol, fill)) {}
 
 /**
- * @brief Set the state of the card to clicked.
- */
-void Card::click() { _clicked = true; }
-
-/**
- * @brief Set the state of the card to unclicked.
+ * @brief Get the packed base-3 index of the card.
+ *
+ * @return Index of the card (0-80).
  */
-void Card::unclick() { _clicked = false; }
+unsigned char Card::get_index() const { return _index; }
 
 /**
  * @brief Get the number of symbols on the card.
  *
  * @return Number of symbols on the card.
  */
-unsigned char Card::get_number_of_symbols() const { return _number_of_symbols; }
+unsigned char Card::get_number_of_symbols() const {
+  return CardIndex::get_number_of_symbols(_index);
+}
 
 /**
  * @brief Get the colour of the card.
  *
  * @return CardColour of the card.
  */
-CardProperties::CardColour Card::get_colour() const { return _colour; }
+CardProperties::CardColour Card::get_colour() const {
+  return CardIndex::get_colour(_index);
+}
 
 /**
  * @brief Get the symbol on the card.
  *
  * @return CardSymbol of the card.
  */
-CardProperties::CardSymbol Card::get_symbol() const { return _symbol; }
+CardProperties::CardSymbol Card::get_symbol() const {
+  return CardIndex::get_symbol(_index);
+}
 
 /**
  * @brief Get the fill type of the card.
  *
  * @return CardFill of the card.
  */
-CardProperties::CardFill Card::get_fill() const { return _fill; }
+CardProperties::CardFill Card::get_fill() const {
+  return CardIndex::get_fill(_index);
+}
 
 /**
- * @brief Check if the card is clicked.
+ * @brief Get the card with the given index from the table that is shared by
+ * all games.
  *
- * @return True if the card has been clicked.
+ * @param index Index of a card (0-80).
+ * @return Constant reference to the card.
  */
-bool Card::is_clicked() const { return _clicked; }
+const Card &Card::get_card(unsigned char index) {
+  return CARD_TABLE.get_card(index);
+}
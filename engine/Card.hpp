@@ -27,41 +27,44 @@
 #ifndef OPENSET_CARD_HPP
 #define OPENSET_CARD_HPP
 
+#include "CardIndex.hpp"
 #include "CardProperties.hpp"
 
 /**
  * @brief Single card in the game.
+ *
+ * The card properties are not stored explicitly, but are decoded from the
+ * packed card index (see CardIndex.hpp). Cards are immutable: all 81 cards are
+ * stored in a single table that is shared by all games (see get_card()).
  */
 class Card {
 private:
-  /*! @brief Number of symbols on the card. */
-  unsigned char _number_of_symbols;
-
-  /*! @brief Card colour. */
-  CardProperties::CardColour _colour;
+  /*! @brief Packed base-3 index of the card. */
+  unsigned char _index;
 
-  /*! @brief Symbol type. */
-  CardProperties::CardSymbol _symbol;
-
-  /*! @brief Fill type. */
-  CardProperties::CardFill _fill;
+public:
+  /**
+   * @brief Empty constructor.
+   */
+  constexpr Card() : _index(CardIndex::CARDINDEX_COUNTER) {}
 
-  /*! @brief Was this card clicked or not? */
-  bool _clicked;
+  /**
+   * @brief Constructor.
+   *
+   * @param index Packed base-3 index of the card (0-80).
+   */
+  constexpr Card(unsigned char index) : _index(index) {}
 
-public:
-  Card();
   Card(unsigned char number_of_symbols, CardProperties::CardColour colour,
        CardProperties::CardSymbol symbol, CardProperties::CardFill fill);
 
-  void click();
-  void unclick();
-
+  unsigned char get_index() const;
   unsigned char get_number_of_symbols() const;
   CardProperties::CardColour get_colour() const;
   CardProperties::CardSymbol get_symbol() const;
   CardProperties::CardFill get_fill() const;
-  bool is_clicked() const;
+
+  static const Card &get_card(unsigned char index);
 };
 
 #endif // OPENSET_CARD_HPP
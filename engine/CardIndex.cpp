@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file CardIndex.cpp
+ *
+ * @brief Compile time sanity checks on the card encoding.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "CardIndex.hpp"
+
+// sanity checks on the encoding: these are evaluated at compile time
+static_assert(CardIndex::CARDINDEX_COUNTER == 81,
+              "The card encoding assumes 81 cards!");
+static_assert(CardIndex::ClassicRules::CARD_COUNTER ==
+                  CardIndex::CARDINDEX_COUNTER,
+              "The classic rules do not match the card encoding!");
+static_assert(CardIndex::get_index(3, CardProperties::CARDCOLOUR_GREEN,
+                                   CardProperties::CARDSYMBOL_WIGGLE,
+                                   CardProperties::CARDFILL_FULL) == 80,
+              "Wrong card encoding!");
+static_assert(
+    CardIndex::ClassicRules::THIRD_CARD_TABLE.get_third_card(0, 1) == 2,
+    "Wrong third card!");
+static_assert(
+    CardIndex::ClassicRules::THIRD_CARD_TABLE.get_third_card(0, 80) == 40,
+    "Wrong third card!");
+static_assert(CardIndex::ClassicRules::get_value(
+                  CardIndex::get_index(2, CardProperties::CARDCOLOUR_BLUE,
+                                       CardProperties::CARDSYMBOL_OVAL,
+                                       CardProperties::CARDFILL_EMPTY),
+                  3) == 1,
+              "The classic rules do not match the card encoding!");
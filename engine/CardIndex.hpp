@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file CardIndex.hpp
+ *
+ * @brief Packed base-3 card encoding and the classic set rules.
+ *
+ * Every card is uniquely identified by an index in the range [0, 81[, where
+ * each of the four card properties makes up one base-3 digit:
+ * @f[
+ *   index = 27 (n - 1) + 9 c + 3 s + f,
+ * @f]
+ * with @f$n@f$ the number of symbols (1-3), @f$c@f$ the CardColour, @f$s@f$
+ * the CardSymbol and @f$f@f$ the CardFill.
+ *
+ * Three cards make up a set if every digit is either the same for all three
+ * cards or different for all three cards, which is equivalent to the sum of
+ * the three digits being a multiple of 3. For every pair of cards there is
+ * hence exactly one card that completes the set. The set rules themselves are
+ * the 4 attribute instance of the generic rules in SetRules.hpp.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_CARDINDEX_HPP
+#define OPENSET_CARDINDEX_HPP
+
+#include "CardProperties.hpp"
+#include "SetRules.hpp"
+
+/**
+ * @brief Packed base-3 card encoding.
+ */
+namespace CardIndex {
+
+/*! @brief Total number of cards in the game. */
+const static unsigned char CARDINDEX_COUNTER =
+    CardProperties::CARDNUMBER_COUNTER * CardProperties::CARDCOLOUR_COUNTER *
+    CardProperties::CARDSYMBOL_COUNTER * CardProperties::CARDFILL_COUNTER;
+
+/*! @brief Set rules for the classic game: 4 attributes with 3 values each. */
+typedef SetRules<4> ClassicRules;
+
+/**
+ * @brief Get the index of the card with the given properties.
+ *
+ * @param number_of_symbols Number of symbols on the card (1-3).
+ * @param colour Colour of the card.
+ * @param symbol Symbol type.
+ * @param fill Fill type.
+ * @return Index of the card.
+ */
+constexpr unsigned char get_index(unsigned char number_of_symbols,
+                                  CardProperties::CardColour colour,
+                                  CardProperties::CardSymbol symbol,
+                                  CardProperties::CardFill fill) {
+  return 27 * (number_of_symbols - 1) + 9 * colour + 3 * symbol + fill;
+}
+
+/**
+ * @brief Get the number of symbols on the card with the given index.
+ *
+ * @param index Index of a card.
+ * @return Number of symbols on the card (1-3).
+ */
+constexpr unsigned char get_number_of_symbols(unsigned char index) {
+  return index / 27 + 1;
+}
+
+/**
+ * @brief Get the colour of the card with the given index.
+ *
+ * @param index Index of a card.
+ * @return CardColour of the card.
+ */
+constexpr CardProperties::CardColour get_colour(unsigned char index) {
+  return static_cast<CardProperties::CardColour>((index / 9) % 3);
+}
+
+/**
+ * @brief Get the symbol on the card with the given index.
+ *
+ * @param index Index of a card.
+ * @return CardSymbol of the card.
+ */
+constexpr CardProperties::CardSymbol get_symbol(unsigned char index) {
+  return static_cast<CardProperties::CardSymbol>((index / 3) % 3);
+}
+
+/**
+ * @brief Get the fill type of the card with the given index.
+ *
+ * @param index Index of a card.
+ * @return CardFill of the card.
+ */
+constexpr CardProperties::CardFill get_fill(unsigned char index) {
+  return static_cast<CardProperties::CardFill>(index % 3);
+}
+
+/**
+ * @brief Get the index of the card that completes the set for the given pair
+ * of cards.
+ *
+ * @param card1 Index of the first card.
+ * @param card2 Index of the second card.
+ * @return Index of the third card.
+ */
+inline unsigned char get_third_card(unsigned char card1, unsigned char card2) {
+  return ClassicRules::get_third_card(card1, card2);
+}
+
+/**
+ * @brief Check if the three cards with the given indices make up a set.
+ *
+ * @param card1 Index of the first card.
+ * @param card2 Index of the second card.
+ * @param card3 Index of the third card.
+ * @return True if the three cards make up a set.
+ */
+inline bool is_set(unsigned char card1, unsigned char card2,
+                   unsigned char card3) {
+  return ClassicRules::is_set(card1, card2, card3);
+}
+}
+
+#endif // OPENSET_CARDINDEX_HPP
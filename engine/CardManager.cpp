@@ -25,103 +25,243 @@
  */
 
 #include "CardManager.hpp"
+#include "GameLogWriter.hpp"
+#include "RandomGenerator.hpp"
 
-#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <cstdlib>
-#include <ctime>
-
-/**
- * @brief Utility class used for index sorting the card weight array.
- */
-class CardSorter {
-private:
-  /*! @brief Pointer to the card weight array. */
-  int *_weights;
-
-public:
-  /**
-   * @brief Constructor.
-   *
-   * @param weights Pointer to the card weights array.
-   */
-  CardSorter(int *weights) : _weights(weights) {}
-
-  /**
-   * @brief Sort function.
-   *
-   * @param a Index of element A.
-   * @param b Index of element B.
-   * @return True if the weight for element A is smaller than that for element
-   * B.
-   */
-  bool operator()(const unsigned char a, const unsigned char b) {
-    return _weights[a] < _weights[b];
-  }
-};
+#include <chrono>
+#include <random>
 
 /**
  * @brief Constructor.
+ *
+ * The cards are shuffled using a seed that is different for every call.
  */
-CardManager::CardManager() : _num_clicked(0) {
-  // initialize the random generator
-  srand(time(NULL));
-
-  // array that will be used to randomly shuffle the cards
-  int card_order_weights[CardProperties::CARDNUMBER_COUNTER *
-                         CardProperties::CARDCOLOUR_COUNTER *
-                         CardProperties::CARDSYMBOL_COUNTER *
-                         CardProperties::CARDFILL_COUNTER];
-
-  // create the cards
-  unsigned char card_index = 0;
-  for (unsigned char number_of_symbols = 1;
-       number_of_symbols <= CardProperties::CARDNUMBER_COUNTER;
-       ++number_of_symbols) {
-    for (int colour = 0; colour < CardProperties::CARDCOLOUR_COUNTER;
-         ++colour) {
-      for (int symbol = 0; symbol < CardProperties::CARDSYMBOL_COUNTER;
-           ++symbol) {
-        for (int fill = 0; fill < CardProperties::CARDFILL_COUNTER; ++fill) {
-          _cards[card_index] =
-              Card(number_of_symbols,
-                   static_cast<CardProperties::CardColour>(colour),
-                   static_cast<CardProperties::CardSymbol>(symbol),
-                   static_cast<CardProperties::CardFill>(fill));
-          card_order_weights[card_index] = rand();
-          _card_stack[card_index] = card_index;
-          ++card_index;
-        }
-      }
-    }
-  }
+CardManager::CardManager() : CardManager(get_random_seed()) {}
 
-  // argument sort the card_order_weights array; this effectively shuffles the
-  // cards
-  CardSorter sorter(card_order_weights);
-  std::sort(&_card_stack[0], &_card_stack[0] + card_index, sorter);
+/**
+ * @brief Constructor.
+ *
+ * Two CardManagers with the same seed deal exactly the same game. No global
+ * state is used, so that CardManagers can safely be constructed concurrently.
+ *
+ * @param seed Seed for the random generator used to shuffle the cards.
+ */
+CardManager::CardManager(uint64_t seed)
+    : _seed(seed), _state(), _set_index_valid(false), _recorder(NULL) {
+  // the cards themselves are stored in a shared table; we only need to
+  // shuffle their indices
+  for (unsigned char card_index = 0; card_index < CardIndex::CARDINDEX_COUNTER;
+       ++card_index) {
+    _state._card_stack[card_index] = card_index;
+  }
+  RandomGenerator random_generator(seed);
+  random_generator.shuffle(_state._card_stack, CardIndex::CARDINDEX_COUNTER);
 
   // set up the main deck
-  _main_deck.resize(12, 0);
-  for (unsigned char card = 0; card < 12; ++card) {
-    _main_deck[card] = _card_stack[card];
+  for (unsigned char card = 0; card < BASE_BOARD_SIZE; ++card) {
+    _state._main_deck[card] = _state._card_stack[card];
+  }
+  _state._main_deck_size = BASE_BOARD_SIZE;
+  _state._next_card = BASE_BOARD_SIZE;
+  _state._clicked = 0;
+
+  update_set_index();
+  deal_extra_cards();
+}
+
+/**
+ * @brief Constructor used by fork() and by GameLogReader::replay().
+ *
+ * Only the seed and the state are copied. The set index is rebuilt when it is
+ * first needed, and the new game is not recorded.
+ *
+ * @param seed Seed of the game.
+ * @param state State of the game.
+ */
+CardManager::CardManager(uint64_t seed, const GameState &state)
+    : _seed(seed), _state(state), _set_index_valid(false), _recorder(NULL) {}
+
+/**
+ * @brief Copy constructor.
+ *
+ * The copy is not recorded: both games would otherwise append their events to
+ * the same log.
+ *
+ * @param card_manager CardManager to copy.
+ */
+CardManager::CardManager(const CardManager &card_manager)
+    : _seed(card_manager._seed), _state(card_manager._state),
+      _set_index(card_manager._set_index),
+      _set_index_valid(card_manager._set_index_valid), _recorder(NULL) {}
+
+/**
+ * @brief Copy assignment.
+ *
+ * Any recorder attached to this game is detached, since the recorded game is
+ * replaced, and the recorder of the other game is not copied.
+ *
+ * @param card_manager CardManager to copy.
+ * @return Reference to this CardManager.
+ */
+CardManager &CardManager::operator=(const CardManager &card_manager) {
+  _seed = card_manager._seed;
+  _state = card_manager._state;
+  _set_index = card_manager._set_index;
+  _set_index_valid = card_manager._set_index_valid;
+  _recorder = NULL;
+  return *this;
+}
+
+/**
+ * @brief Get a seed that is different for every call.
+ *
+ * Combines the hardware random device (if available) with the current time
+ * and a call counter.
+ *
+ * @return Random seed.
+ */
+uint64_t CardManager::get_random_seed() {
+  static std::atomic<uint64_t> counter(0);
+  std::random_device random_device;
+  uint64_t seed = random_device();
+  seed = (seed << 32) ^ random_device();
+  seed ^= std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  return seed + 0x9e3779b97f4a7c15ull * (++counter);
+}
+
+/**
+ * @brief Get the seed that was used to shuffle the cards.
+ *
+ * @return Seed of the game.
+ */
+uint64_t CardManager::get_seed() const { return _seed; }
+
+/**
+ * @brief Get the current state of the game.
+ *
+ * @return Reference to the GameState.
+ */
+const GameState &CardManager::get_state() const { return _state; }
+
+/**
+ * @brief Take a snapshot of the current state of the game.
+ *
+ * The snapshot is a small plain old data structure (see GameState.hpp) that
+ * contains the card order, the main deck, the position of the next card and
+ * the selection, and that can be copied with memcpy.
+ *
+ * @return Copy of the current GameState.
+ */
+GameState CardManager::snapshot() const { return _state; }
+
+/**
+ * @brief Restore the game to the given snapshot.
+ *
+ * Only the state is copied; the set index is rebuilt lazily, the first time
+ * it is needed. Restoring a snapshot is not recorded by the recorder, if
+ * there is one.
+ *
+ * @param state Snapshot taken with snapshot() (of this or another game with
+ * the same seed).
+ */
+void CardManager::restore(const GameState &state) {
+  _state = state;
+  _set_index_valid = false;
+}
+
+/**
+ * @brief Create an independent copy of this game.
+ *
+ * The copy only copies the seed and the GameState, so that branching in a
+ * tree search costs a copy of two cache lines. The copy is not recorded.
+ *
+ * @return Copy of this game.
+ */
+CardManager CardManager::fork() const { return CardManager(_seed, _state); }
+
+/**
+ * @brief Check if the main deck contains a set, without rebuilding the set
+ * index if it is invalid.
+ *
+ * @return True if there is a set on the main deck.
+ */
+bool CardManager::board_has_set() const {
+  if (_set_index_valid) {
+    return _set_index.set_count() > 0;
+  }
+  return has_set(_state._main_deck, _state._main_deck_size);
+}
+
+/**
+ * @brief Rebuild the set index if it does not match the main deck.
+ *
+ * The index is invalidated by restore() and by forking.
+ */
+void CardManager::update_set_index() const {
+  if (!_set_index_valid) {
+    _set_index.rebuild(_state._main_deck, _state._main_deck_size);
+    _set_index_valid = true;
+  }
+}
+
+/**
+ * @brief Record all events of this game using the given recorder.
+ *
+ * The recorder is started immediately: it logs the seed, the card order and
+ * the current state of the game. The recorder is not owned by the
+ * CardManager and should stay alive as long as it is attached.
+ *
+ * @param recorder GameLogWriter (NULL to stop recording).
+ */
+void CardManager::set_recorder(GameLogWriter *recorder) {
+  _recorder = recorder;
+  if (_recorder != NULL) {
+    _recorder->begin(_seed, _state);
   }
-  _next_card = 13;
 }
 
 /**
  * @brief Get the cards that are currently in the main deck.
  *
+ * This function returns a copy of the main deck. Use get_board() or
+ * get_board_indices() to access the main deck without copying it.
+ *
  * @return Cards that are currently in the main deck.
  */
 std::vector<Card> CardManager::get_deck() const {
   std::vector<Card> deck;
-  for (unsigned char card = 0; card < _main_deck.size(); ++card) {
-    deck.push_back(_cards[_main_deck[card]]);
+  for (unsigned char card = 0; card < _state._main_deck_size; ++card) {
+    deck.push_back(Card::get_card(_state._main_deck[card]));
   }
   return deck;
 }
 
+/**
+ * @brief Get a view on the cards that are currently in the main deck.
+ *
+ * The view does not copy or allocate anything, but is only valid until the
+ * main deck changes.
+ *
+ * @return BoardView on the main deck.
+ */
+BoardView CardManager::get_board() const {
+  return BoardView(_state._main_deck, _state._main_deck_size);
+}
+
+/**
+ * @brief Get the indices of the cards that are currently in the main deck.
+ *
+ * The span does not copy or allocate anything, but is only valid until the
+ * main deck changes.
+ *
+ * @return IndexSpan on the card indices in the main deck.
+ */
+IndexSpan CardManager::get_board_indices() const {
+  return IndexSpan(_state._main_deck, _state._main_deck_size);
+}
+
 /**
  * @brief Get a reference to the card with the given index.
  *
@@ -129,89 +269,296 @@ std::vector<Card> CardManager::get_deck() const {
  * @return constant reference to that card.
  */
 const Card &CardManager::get_card(unsigned char index) const {
-  return _cards[_main_deck[index]];
+  return Card::get_card(_state._main_deck[index]);
+}
+
+/**
+ * @brief Check if the card with the given index is clicked.
+ *
+ * @param index Index of a card on the main deck.
+ * @return True if the card is clicked.
+ */
+bool CardManager::is_clicked(unsigned char index) const {
+  return (_state._clicked >> index) & 1;
 }
 
 /**
  * @brief Click the card with the given index.
+ *
+ * Clicking a card that was already clicked unclicks it. As soon as three cards
+ * are clicked, we check if they make up a set.
+ *
+ * @param index Index of a card on the main deck.
+ * @return Dirty mask: bit i is set if the card with index i on the main deck
+ * changed (was clicked, unclicked, replaced or removed).
  */
-void CardManager::click_card(unsigned char index) {
-  unsigned char i = 0;
-  while (i < _num_clicked && _clicked[i] != index) {
-    ++i;
+uint32_t CardManager::click_card(unsigned char index) {
+  assert(index < _state._main_deck_size);
+  uint32_t dirty = uint32_t(1) << index;
+  _state._clicked ^= dirty;
+  if (_recorder != NULL) {
+    _recorder->record(GAMELOGEVENT_CLICK, index);
   }
-  if (i == _num_clicked) {
-    assert(i < 3);
-    // new card was clicked
-    _clicked[_num_clicked] = index;
-    _cards[_main_deck[index]].click();
-    ++_num_clicked;
-  } else {
-    // clicked card was clicked again
-    _cards[_main_deck[index]].unclick();
-    unsigned char j = i + 1;
-    while (j < _num_clicked) {
-      _clicked[i] = _clicked[j];
-      ++i;
-      ++j;
-    }
-    --_num_clicked;
+  if (__builtin_popcount(_state._clicked) == 3) {
+    dirty |= check_set();
   }
-
-  if (_num_clicked == 3) {
-    check_set();
+  if (_recorder != NULL) {
+    _recorder->end_move(_state);
   }
+  return dirty;
 }
 
 /**
  * @brief Check if the clicked cards make up a set, and if so, remove it.
+ *
+ * If the main deck has its base size, the cards of the set are replaced by new
+ * cards from the card stack. If the main deck was expanded, or if the card
+ * stack is empty, the cards are removed from the main deck instead, so that
+ * the main deck shrinks. If the resulting main deck does not contain a set,
+ * extra cards are dealt (see deal_extra_cards()). In all cases, the selection
+ * is cleared.
+ *
+ * @return Dirty mask: bit i is set if the card with index i on the main deck
+ * changed (was unclicked, replaced, moved, removed or added).
  */
-void CardManager::check_set() {
-  if (is_set(_cards[_main_deck[_clicked[0]]], _cards[_main_deck[_clicked[1]]],
-             _cards[_main_deck[_clicked[2]]])) {
+uint32_t CardManager::check_set() {
+  assert(__builtin_popcount(_state._clicked) == 3);
+
+  // the clicked cards always change: they are either unclicked or replaced
+  uint32_t dirty = _state._clicked;
+
+  // get the indices of the clicked cards (in increasing order)
+  unsigned char clicked[3];
+  uint32_t selection = _state._clicked;
+  for (unsigned char i = 0; i < 3; ++i) {
+    clicked[i] = __builtin_ctz(selection);
+    selection &= selection - 1;
+  }
+  _state._clicked = 0;
+
+  if (CardIndex::is_set(_state._main_deck[clicked[0]],
+                        _state._main_deck[clicked[1]],
+                        _state._main_deck[clicked[2]])) {
+    // the set index is updated incrementally: only sets containing the
+    // removed or new cards change. An invalid index (after restore()) stays
+    // invalid until it is needed
+    if (_set_index_valid) {
+      for (unsigned char i = 0; i < 3; ++i) {
+        _set_index.remove_card(_state._main_deck[clicked[i]]);
+      }
+    }
     unsigned char next_clicked = 0;
-    while (_next_card < 81 && next_clicked < 3) {
-      _main_deck[_clicked[next_clicked]] = _card_stack[_next_card];
-      ++next_clicked;
-      ++_next_card;
+    if (_state._main_deck_size <= BASE_BOARD_SIZE) {
+      while (_state._next_card < CardIndex::CARDINDEX_COUNTER &&
+             next_clicked < 3) {
+        _state._main_deck[clicked[next_clicked]] =
+            _state._card_stack[_state._next_card];
+        if (_set_index_valid) {
+          _set_index.add_card(_state._main_deck[clicked[next_clicked]]);
+        }
+        ++next_clicked;
+        ++_state._next_card;
+      }
+    }
+    if (next_clicked < 3) {
+      dirty |= remove_cards(clicked + next_clicked, 3 - next_clicked);
+    }
+    if (_recorder != NULL) {
+      _recorder->record(GAMELOGEVENT_SET_FOUND, 0);
+    }
+    dirty |= deal_extra_cards();
+  } else if (_recorder != NULL) {
+    _recorder->record(GAMELOGEVENT_SET_REJECTED, 0);
+  }
+  return dirty;
+}
+
+/**
+ * @brief Remove the cards at the given positions from the main deck.
+ *
+ * The cards at the end of the main deck are moved into the holes left by the
+ * removed cards, so that all other cards stay in place. The removed cards
+ * should already have been removed from the set index.
+ *
+ * @param positions Positions of the cards to remove (in increasing order).
+ * @param number_of_positions Number of cards to remove.
+ * @return Dirty mask: the positions of the removed cards and all positions
+ * from the new size of the main deck up to the old size.
+ */
+uint32_t CardManager::remove_cards(const unsigned char *positions,
+                                   unsigned char number_of_positions) {
+  uint32_t holes = 0;
+  for (unsigned char i = 0; i < number_of_positions; ++i) {
+    holes |= uint32_t(1) << positions[i];
+  }
+  const unsigned char old_size = _state._main_deck_size;
+  const unsigned char new_size = old_size - number_of_positions;
+
+  // cards beyond the new size that are not removed fill the holes before the
+  // new size
+  unsigned char next_position = new_size;
+  for (unsigned char i = 0; i < number_of_positions; ++i) {
+    if (positions[i] < new_size) {
+      while ((holes >> next_position) & 1) {
+        ++next_position;
+      }
+      _state._main_deck[positions[i]] = _state._main_deck[next_position];
+      ++next_position;
+    }
+  }
+  _state._main_deck_size = new_size;
+
+  return holes | ((uint32_t(1) << old_size) - (uint32_t(1) << new_size));
+}
+
+/**
+ * @brief Deal extra cards as long as the main deck does not contain a set.
+ *
+ * Cards are dealt in groups of 3, until the main deck contains a set, reaches
+ * its maximum size, or the card stack is empty. Checking for a set is a
+ * constant time lookup in the set index (or a scan of the main deck that stops
+ * at the first set if the index is invalid), so that this check is cheap
+ * enough to run after every move.
+ *
+ * @return Dirty mask: the positions of the cards that were added.
+ */
+uint32_t CardManager::deal_extra_cards() {
+  uint32_t dirty = 0;
+  while (!board_has_set() && _state._main_deck_size + 3 <= MAX_BOARD_SIZE &&
+         _state._next_card < CardIndex::CARDINDEX_COUNTER) {
+    for (unsigned char i = 0;
+         i < 3 && _state._next_card < CardIndex::CARDINDEX_COUNTER; ++i) {
+      _state._main_deck[_state._main_deck_size] =
+          _state._card_stack[_state._next_card];
+      if (_set_index_valid) {
+        _set_index.add_card(_state._main_deck[_state._main_deck_size]);
+      }
+      dirty |= uint32_t(1) << _state._main_deck_size;
+      ++_state._main_deck_size;
+      ++_state._next_card;
     }
-  } else {
-    _cards[_main_deck[_clicked[0]]].unclick();
-    _cards[_main_deck[_clicked[1]]].unclick();
-    _cards[_main_deck[_clicked[2]]].unclick();
   }
-  _num_clicked = 0;
+  if (dirty != 0 && _recorder != NULL) {
+    _recorder->record(GAMELOGEVENT_DEAL, _state._main_deck_size);
+  }
+  return dirty;
 }
 
 /**
  * @brief Check if the three given cards make up a set.
  *
+ * This is a single lookup in the third card table (see CardIndex.hpp).
+ *
  * @param card1 First card.
  * @param card2 Second card.
  * @param card3 Third card.
  * @return True if the three cards make up a set.
  */
-bool CardManager::is_set(Card &card1, Card &card2, Card &card3) {
-  bool colour_set = (card1.get_colour() == card2.get_colour() &&
-                     card1.get_colour() == card3.get_colour()) ||
-                    (card1.get_colour() != card2.get_colour() &&
-                     card1.get_colour() != card3.get_colour() &&
-                     card2.get_colour() != card3.get_colour());
-  bool symbol_set = (card1.get_symbol() == card2.get_symbol() &&
-                     card1.get_symbol() == card3.get_symbol()) ||
-                    (card1.get_symbol() != card2.get_symbol() &&
-                     card1.get_symbol() != card3.get_symbol() &&
-                     card2.get_symbol() != card3.get_symbol());
-  bool fill_set = (card1.get_fill() == card2.get_fill() &&
-                   card1.get_fill() == card3.get_fill()) ||
-                  (card1.get_fill() != card2.get_fill() &&
-                   card1.get_fill() != card3.get_fill() &&
-                   card2.get_fill() != card3.get_fill());
-  bool num_set =
-      (card1.get_number_of_symbols() == card2.get_number_of_symbols() &&
-       card1.get_number_of_symbols() == card3.get_number_of_symbols()) ||
-      (card1.get_number_of_symbols() != card2.get_number_of_symbols() &&
-       card1.get_number_of_symbols() != card3.get_number_of_symbols() &&
-       card2.get_number_of_symbols() != card3.get_number_of_symbols());
-  return colour_set && symbol_set && fill_set && num_set;
+bool CardManager::is_set(const Card &card1, const Card &card2,
+                         const Card &card3) {
+  return CardIndex::is_set(card1.get_index(), card2.get_index(),
+                           card3.get_index());
+}
+
+/**
+ * @brief Get the number of sets on the main deck.
+ *
+ * The sets are kept up to date while playing, so this is a constant time
+ * operation (except for the first call after restore(), which rebuilds the
+ * set index).
+ *
+ * @return Number of sets on the main deck.
+ */
+unsigned char CardManager::set_count() const {
+  update_set_index();
+  return _set_index.set_count();
+}
+
+/**
+ * @brief Get the index of the sets on the main deck.
+ *
+ * The index contains the sets as card indices. It is only valid until the main
+ * deck changes.
+ *
+ * @return Reference to the set index.
+ */
+const SetIndex &CardManager::get_sets() const {
+  update_set_index();
+  return _set_index;
+}
+
+/**
+ * @brief Find all sets on the main deck.
+ *
+ * @param sets Buffer to store the sets in. Should be large enough to hold
+ * 3 * MAX_NUMBER_OF_SETS indices. Set i is stored in elements 3*i, 3*i+1 and
+ * 3*i+2, as indices of cards on the main deck (in increasing order).
+ * @return Number of sets that was found.
+ */
+unsigned char CardManager::find_all_sets(unsigned char *sets) const {
+  return find_all_sets(_state._main_deck, _state._main_deck_size, sets);
+}
+
+/**
+ * @brief Count the number of sets on the main deck.
+ *
+ * Same as set_count().
+ *
+ * @return Number of sets on the main deck.
+ */
+unsigned char CardManager::count_sets() const { return set_count(); }
+
+/**
+ * @brief Check if the main deck contains at least one set.
+ *
+ * This is a constant time lookup in the set index.
+ *
+ * @return True if there is a set on the main deck.
+ */
+bool CardManager::has_set() const { return set_count() > 0; }
+
+/**
+ * @brief Find all sets on the given board.
+ *
+ * The board can contain up to MAX_BOARD_SIZE distinct cards. No memory is
+ * allocated. See SetRules::find_all_sets() for the algorithm.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @param sets Buffer to store the sets in. Should be large enough to hold
+ * 3 * MAX_NUMBER_OF_SETS indices. Set i is stored in elements 3*i, 3*i+1 and
+ * 3*i+2, as positions on the board (in increasing order).
+ * @return Number of sets that was found.
+ */
+unsigned char CardManager::find_all_sets(const unsigned char *board,
+                                         unsigned char board_size,
+                                         unsigned char *sets) {
+  assert(board_size <= MAX_BOARD_SIZE);
+  return CardIndex::ClassicRules::find_all_sets(board, board_size, sets);
+}
+
+/**
+ * @brief Count the number of sets on the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @return Number of sets on the board.
+ */
+unsigned char CardManager::count_sets(const unsigned char *board,
+                                      unsigned char board_size) {
+  assert(board_size <= MAX_BOARD_SIZE);
+  return CardIndex::ClassicRules::count_sets(board, board_size);
+}
+
+/**
+ * @brief Check if the given board contains at least one set.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @return True if there is a set on the board.
+ */
+bool CardManager::has_set(const unsigned char *board,
+                          unsigned char board_size) {
+  assert(board_size <= MAX_BOARD_SIZE);
+  return CardIndex::ClassicRules::has_set(board, board_size);
 }
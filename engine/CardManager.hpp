@@ -27,51 +27,110 @@
 #ifndef OPENSET_CARDMANAGER_HPP
 #define OPENSET_CARDMANAGER_HPP
 
+#include "BoardView.hpp"
 #include "Card.hpp"
+#include "CardIndex.hpp"
 #include "CardProperties.hpp"
+#include "GameState.hpp"
+#include "SetIndex.hpp"
 
+#include <cstdint>
 #include <vector>
 
+class GameLogWriter;
+
 /**
  * @brief Backbone of the game: class that keeps track of which cards are where.
  */
 class CardManager {
+public:
+  /*! @brief Number of cards on the main deck at the start of the game. */
+  static const unsigned char BASE_BOARD_SIZE = 12;
+
+  /*! @brief Maximum number of cards on the main deck. */
+  static const unsigned char MAX_BOARD_SIZE = GameState::MAX_BOARD_SIZE;
+
+  /*! @brief Maximum number of sets on the main deck (see SetIndex). */
+  static const unsigned char MAX_NUMBER_OF_SETS = SetIndex::MAX_NUMBER_OF_SETS;
+
 private:
-  /*! @brief Cards. */
-  Card _cards[CardProperties::CARDNUMBER_COUNTER *
-              CardProperties::CARDCOLOUR_COUNTER *
-              CardProperties::CARDSYMBOL_COUNTER *
-              CardProperties::CARDNUMBER_COUNTER];
+  /*! @brief Seed used to shuffle the cards. */
+  uint64_t _seed;
+
+  /*! @brief State of the game: card order, main deck and selection. */
+  GameState _state;
+
+  /*! @brief Sets on the main deck, updated every time cards are replaced.
+   *  The index is derived from the state and is rebuilt lazily after the
+   *  state was restored. */
+  mutable SetIndex _set_index;
+
+  /*! @brief Does the set index match the main deck? */
+  mutable bool _set_index_valid;
+
+  /*! @brief Recorder that logs all events (NULL if events are not
+   *  recorded). */
+  GameLogWriter *_recorder;
 
-  unsigned char _card_stack[CardProperties::CARDNUMBER_COUNTER *
-                            CardProperties::CARDCOLOUR_COUNTER *
-                            CardProperties::CARDSYMBOL_COUNTER *
-                            CardProperties::CARDNUMBER_COUNTER];
+  CardManager(uint64_t seed, const GameState &state);
 
-  /*! @brief Main card deck. */
-  std::vector<unsigned char> _main_deck;
+  // replays start from the checkpoint state in the log
+  friend class GameLogReader;
 
-  /*! @brief Index of the next card that should be added to the deck. */
-  unsigned char _next_card;
+  static uint64_t get_random_seed();
 
-  /*! @brief Indices of clicked cards. */
-  unsigned char _clicked[3];
+  void update_set_index() const;
+  bool board_has_set() const;
 
-  /*! @brief Number of clicked cards. */
-  unsigned char _num_clicked;
+  uint32_t remove_cards(const unsigned char *positions,
+                        unsigned char number_of_positions);
+  uint32_t deal_extra_cards();
 
 public:
   CardManager();
+  CardManager(uint64_t seed);
+
+  // copies never inherit the recorder of the original game
+  CardManager(const CardManager &card_manager);
+  CardManager &operator=(const CardManager &card_manager);
+
+  uint64_t get_seed() const;
+  const GameState &get_state() const;
+
+  void set_recorder(GameLogWriter *recorder);
+
+  GameState snapshot() const;
+  void restore(const GameState &state);
+  CardManager fork() const;
 
   std::vector<Card> get_deck() const;
+  BoardView get_board() const;
+  IndexSpan get_board_indices() const;
 
   const Card &get_card(unsigned char index) const;
 
-  void click_card(unsigned char index);
+  bool is_clicked(unsigned char index) const;
+
+  uint32_t click_card(unsigned char index);
+
+  uint32_t check_set();
+
+  static bool is_set(const Card &card1, const Card &card2,
+                     const Card &card3);
+
+  unsigned char set_count() const;
+  const SetIndex &get_sets() const;
 
-  void check_set();
+  unsigned char find_all_sets(unsigned char *sets) const;
+  unsigned char count_sets() const;
+  bool has_set() const;
 
-  static bool is_set(Card &card1, Card &card2, Card &card3);
+  static unsigned char find_all_sets(const unsigned char *board,
+                                     unsigned char board_size,
+                                     unsigned char *sets);
+  static unsigned char count_sets(const unsigned char *board,
+                                  unsigned char board_size);
+  static bool has_set(const unsigned char *board, unsigned char board_size);
 };
 
 #endif // OPENSET_CARDMANAGER_HPP
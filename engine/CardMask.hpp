@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file CardMask.hpp
+ *
+ * @brief Membership bitmask over all cards in the game.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_CARDMASK_HPP
+#define OPENSET_CARDMASK_HPP
+
+#include "CardIndex.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Membership bitmask over all cards in the game.
+ *
+ * Every card index (see CardIndex.hpp) corresponds to a single bit, so that
+ * adding, removing and looking up cards are all constant time operations that
+ * do not require any memory allocation.
+ */
+class CardMask {
+private:
+  /*! @brief Bits: bit i of word i/64 is set if card i is in the mask. */
+  uint64_t _bits[2];
+
+public:
+  /**
+   * @brief Empty constructor.
+   */
+  inline CardMask() : _bits{0, 0} {}
+
+  /**
+   * @brief Constructor.
+   *
+   * @param word0 Bits for the cards [0, 64[.
+   * @param word1 Bits for the cards [64, 128[.
+   */
+  inline CardMask(uint64_t word0, uint64_t word1) : _bits{word0, word1} {}
+
+  /**
+   * @brief Add the card with the given index to the mask.
+   *
+   * @param index Index of a card.
+   */
+  inline void add(unsigned char index) {
+    _bits[index >> 6] |= uint64_t(1) << (index & 63);
+  }
+
+  /**
+   * @brief Remove the card with the given index from the mask.
+   *
+   * @param index Index of a card.
+   */
+  inline void remove(unsigned char index) {
+    _bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+  }
+
+  /**
+   * @brief Check if the card with the given index is in the mask.
+   *
+   * @param index Index of a card.
+   * @return True if the card is in the mask.
+   */
+  inline bool contains(unsigned char index) const {
+    return (_bits[index >> 6] >> (index & 63)) & 1;
+  }
+
+  /**
+   * @brief Get the number of cards in the mask.
+   *
+   * @return Number of cards in the mask.
+   */
+  inline unsigned char count() const {
+    return __builtin_popcountll(_bits[0]) + __builtin_popcountll(_bits[1]);
+  }
+
+  /**
+   * @brief Get one of the two underlying 64-bit words.
+   *
+   * @param word Index of the word (0 or 1).
+   * @return Bits for the cards [64*word, 64*word+64[.
+   */
+  inline uint64_t get_word(unsigned char word) const { return _bits[word]; }
+
+  /**
+   * @brief Compare two masks.
+   *
+   * @param mask Other mask.
+   * @return True if both masks contain exactly the same cards.
+   */
+  inline bool operator==(const CardMask &mask) const {
+    return _bits[0] == mask._bits[0] && _bits[1] == mask._bits[1];
+  }
+};
+
+#endif // OPENSET_CARDMASK_HPP
@@ -0,0 +1,342 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file GameEngine.cpp
+ *
+ * @brief GameEngine implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "GameEngine.hpp"
+
+#include <chrono>
+
+/**
+ * @brief Add a latency to the given total and maximum.
+ *
+ * Every latency counter is only written by a single thread, so a relaxed load
+ * and store suffice.
+ *
+ * @param latency Latency (in ns).
+ * @param total Total latency.
+ * @param max Maximum latency.
+ */
+static void add_latency(uint64_t latency, std::atomic<uint64_t> &total,
+                        std::atomic<uint64_t> &max) {
+  total.store(total.load(std::memory_order_relaxed) + latency,
+              std::memory_order_relaxed);
+  if (latency > max.load(std::memory_order_relaxed)) {
+    max.store(latency, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Starts the engine thread.
+ *
+ * @param card_manager Game. Should not be accessed by any other thread while
+ * the engine is running.
+ * @param notify_function Function called by the engine thread every time a
+ * notification is available (NULL if the user interface polls).
+ * @param notify_data Data passed on to the notify function.
+ */
+GameEngine::GameEngine(CardManager &card_manager,
+                       NotifyFunction notify_function, void *notify_data)
+    : _card_manager(card_manager), _notify_function(notify_function),
+      _notify_data(notify_data), _sleeping(false), _stop(false),
+      _number_of_commands(0), _number_of_dropped_commands(0),
+      _total_command_latency(0), _max_command_latency(0),
+      _number_of_notifications(0), _total_round_trip_latency(0),
+      _max_round_trip_latency(0), _thread(&GameEngine::run, this) {}
+
+/**
+ * @brief Destructor.
+ *
+ * Stops the engine thread (if it is still running).
+ */
+GameEngine::~GameEngine() { stop(); }
+
+/**
+ * @brief Stop the engine thread.
+ *
+ * Commands that are still in the queue are handled first. After this call,
+ * the notify function is no longer called. Should be called by the user
+ * interface thread; calling it more than once has no effect.
+ */
+void GameEngine::stop() {
+  if (!_thread.joinable()) {
+    return;
+  }
+  _stop.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(_sleep_mutex);
+  }
+  _wake_up.notify_one();
+  _thread.join();
+}
+
+/**
+ * @brief Get the current time, as used for the command timestamps.
+ *
+ * @return Time since the epoch of the steady clock (in ns).
+ */
+uint64_t GameEngine::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Main loop of the engine thread.
+ */
+void GameEngine::run() {
+  EngineCommand command;
+  while (true) {
+    if (_commands.try_pop(command)) {
+      handle_command(command);
+      continue;
+    }
+    if (_stop.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(_sleep_mutex);
+    _sleeping.store(true);
+    // a command that was pushed before the user interface could see the flag
+    // is seen below; a command that was pushed after wakes us up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    _wake_up.wait(lock, [this] {
+      return !_commands.empty() || _stop.load(std::memory_order_acquire);
+    });
+    _sleeping.store(false, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Handle a single command and send the resulting notification.
+ *
+ * If the notification queue is full, the engine waits until the user
+ * interface has caught up: notifications are never dropped.
+ *
+ * @param command EngineCommand.
+ */
+void GameEngine::handle_command(const EngineCommand &command) {
+  add_latency(now() - command._time, _total_command_latency,
+              _max_command_latency);
+
+  EngineNotification notification;
+  notification._dirty = 0;
+  // the user interface can send clicks on cards that were removed before it
+  // received the corresponding notification
+  if (command._type == ENGINECOMMAND_CLICK &&
+      command._data < _card_manager.get_board().size()) {
+    notification._dirty = _card_manager.click_card(command._data);
+  }
+  const GameState &state = _card_manager.get_state();
+  notification._clicked = state._clicked;
+  for (unsigned char i = 0; i < GameState::MAX_BOARD_SIZE; ++i) {
+    notification._main_deck[i] = state._main_deck[i];
+  }
+  notification._main_deck_size = state._main_deck_size;
+  notification._command_time = command._time;
+
+  while (!_notifications.try_push(notification)) {
+    if (_stop.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+  _number_of_commands.store(
+      _number_of_commands.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  if (_notify_function != NULL) {
+    _notify_function(_notify_data);
+  }
+}
+
+/**
+ * @brief Send a click on the card at the given position to the engine.
+ *
+ * This function never waits for the engine. Should only be called by the
+ * user interface thread.
+ *
+ * @param index Position of a card on the main deck.
+ * @return True if the command was sent, false if it was dropped because the
+ * command queue is full.
+ */
+bool GameEngine::click_card(unsigned char index) {
+  EngineCommand command;
+  command._type = ENGINECOMMAND_CLICK;
+  command._data = index;
+  command._time = now();
+  if (!_commands.try_push(command)) {
+    _number_of_dropped_commands.store(
+        _number_of_dropped_commands.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    return false;
+  }
+
+  // only wake up the engine if it is (about to go) asleep
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (_sleeping.load()) {
+    {
+      std::lock_guard<std::mutex> lock(_sleep_mutex);
+    }
+    _wake_up.notify_one();
+  }
+  return true;
+}
+
+/**
+ * @brief Get the next notification sent by the engine.
+ *
+ * Should only be called by the user interface thread, which should handle
+ * all available notifications before drawing the board.
+ *
+ * @param notification Variable to store the notification in.
+ * @return True on success, false if no notification is available.
+ */
+bool GameEngine::pop_notification(EngineNotification &notification) {
+  if (!_notifications.try_pop(notification)) {
+    return false;
+  }
+  add_latency(now() - notification._command_time, _total_round_trip_latency,
+              _max_round_trip_latency);
+  _number_of_notifications.store(
+      _number_of_notifications.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @brief Get the number of commands waiting in the command queue.
+ *
+ * @return Number of queued commands.
+ */
+uint32_t GameEngine::get_command_queue_depth() const {
+  return _commands.size();
+}
+
+/**
+ * @brief Get the largest number of commands that was waiting in the command
+ * queue.
+ *
+ * @return Maximum number of queued commands.
+ */
+uint32_t GameEngine::get_max_command_queue_depth() const {
+  return _commands.get_max_size();
+}
+
+/**
+ * @brief Get the number of notifications waiting in the notification queue.
+ *
+ * @return Number of queued notifications.
+ */
+uint32_t GameEngine::get_notification_queue_depth() const {
+  return _notifications.size();
+}
+
+/**
+ * @brief Get the largest number of notifications that was waiting in the
+ * notification queue.
+ *
+ * @return Maximum number of queued notifications.
+ */
+uint32_t GameEngine::get_max_notification_queue_depth() const {
+  return _notifications.get_max_size();
+}
+
+/**
+ * @brief Get the number of commands that was handled by the engine.
+ *
+ * @return Number of handled commands.
+ */
+unsigned long GameEngine::get_number_of_commands() const {
+  return _number_of_commands.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of commands that was dropped because the command
+ * queue was full.
+ *
+ * @return Number of dropped commands.
+ */
+unsigned long GameEngine::get_number_of_dropped_commands() const {
+  return _number_of_dropped_commands.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the average time commands spent in the command queue.
+ *
+ * @return Average command latency (in ns, 0 if no commands were handled).
+ */
+double GameEngine::get_average_command_latency() const {
+  const unsigned long number_of_commands = get_number_of_commands();
+  if (number_of_commands == 0) {
+    return 0.;
+  }
+  return double(_total_command_latency.load(std::memory_order_relaxed)) /
+         number_of_commands;
+}
+
+/**
+ * @brief Get the longest time a command spent in the command queue.
+ *
+ * @return Maximum command latency (in ns).
+ */
+uint64_t GameEngine::get_max_command_latency() const {
+  return _max_command_latency.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of notifications that was received by the user
+ * interface.
+ *
+ * @return Number of received notifications.
+ */
+unsigned long GameEngine::get_number_of_notifications() const {
+  return _number_of_notifications.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the average time between sending a command and receiving the
+ * corresponding notification.
+ *
+ * @return Average round trip latency (in ns, 0 if no notifications were
+ * received).
+ */
+double GameEngine::get_average_round_trip_latency() const {
+  const unsigned long number_of_notifications = get_number_of_notifications();
+  if (number_of_notifications == 0) {
+    return 0.;
+  }
+  return double(_total_round_trip_latency.load(std::memory_order_relaxed)) /
+         number_of_notifications;
+}
+
+/**
+ * @brief Get the longest time between sending a command and receiving the
+ * corresponding notification.
+ *
+ * @return Maximum round trip latency (in ns).
+ */
+uint64_t GameEngine::get_max_round_trip_latency() const {
+  return _max_round_trip_latency.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file GameEngine.hpp
+ *
+ * @brief Runs a CardManager on its own thread.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMEENGINE_HPP
+#define OPENSET_GAMEENGINE_HPP
+
+#include "CardManager.hpp"
+#include "SPSCQueue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Types of commands that can be sent to the engine.
+ */
+enum EngineCommandType {
+  /*! @brief Click a card (data: position on the main deck). */
+  ENGINECOMMAND_CLICK = 0,
+  /*! @brief Counter. Should always be the last element! */
+  ENGINECOMMAND_COUNTER
+};
+
+/**
+ * @brief Command sent from the user interface to the engine.
+ */
+struct EngineCommand {
+  /*! @brief Type of the command (see EngineCommandType). */
+  uint8_t _type;
+
+  /*! @brief Data of the command. */
+  uint8_t _data;
+
+  /*! @brief Time the command was sent (in ns, see GameEngine::now()). */
+  uint64_t _time;
+};
+
+/**
+ * @brief Notification sent from the engine to the user interface: the board
+ * after a command was handled.
+ *
+ * The notification contains everything the user interface needs to draw the
+ * board, so that it never has to access the CardManager.
+ */
+struct EngineNotification {
+  /*! @brief Dirty mask: bit i is set if the card at position i on the main
+   *  deck changed. */
+  uint32_t _dirty;
+
+  /*! @brief Selection: bit i is set if the card at position i is clicked. */
+  uint32_t _clicked;
+
+  /*! @brief Indices of the cards on the main deck. */
+  unsigned char _main_deck[GameState::MAX_BOARD_SIZE];
+
+  /*! @brief Number of cards on the main deck. */
+  unsigned char _main_deck_size;
+
+  /*! @brief Time the command that caused this notification was sent (in ns,
+   *  see GameEngine::now()). */
+  uint64_t _command_time;
+};
+
+/**
+ * @brief Runs a CardManager on its own thread.
+ *
+ * The user interface sends commands to the engine over a lock-free
+ * single-producer/single-consumer queue, and the engine sends a notification
+ * with the new board back over a second queue after every command. Sending a
+ * command never waits for the engine: if the command queue is full, the
+ * command is dropped (and counted).
+ *
+ * When the command queue is empty, the engine thread sleeps on a condition
+ * variable. The mutex of the condition variable is only held by the engine
+ * while it checks the queue, never while it handles commands, and the user
+ * interface only takes it to wake up a sleeping engine.
+ *
+ * After pushing notifications, the engine calls the notify function (if set),
+ * which should make the user interface thread call pop_notification() (e.g.
+ * using g_idle_add()).
+ *
+ * The CardManager should not be accessed by any other thread while the engine
+ * is running.
+ */
+class GameEngine {
+public:
+  /*! @brief Capacity of the command queue. */
+  static const uint32_t COMMAND_QUEUE_SIZE = 64;
+
+  /*! @brief Capacity of the notification queue. */
+  static const uint32_t NOTIFICATION_QUEUE_SIZE = 64;
+
+  /*! @brief Function called by the engine thread when a notification is
+   *  available. */
+  typedef void (*NotifyFunction)(void *data);
+
+private:
+  /*! @brief Game. */
+  CardManager &_card_manager;
+
+  /*! @brief Commands sent by the user interface. */
+  SPSCQueue<EngineCommand, COMMAND_QUEUE_SIZE> _commands;
+
+  /*! @brief Notifications sent by the engine. */
+  SPSCQueue<EngineNotification, NOTIFICATION_QUEUE_SIZE> _notifications;
+
+  /*! @brief Function called when a notification is available. */
+  NotifyFunction _notify_function;
+
+  /*! @brief Data passed on to the notify function. */
+  void *_notify_data;
+
+  /*! @brief Is the engine sleeping (or about to sleep)? */
+  std::atomic<bool> _sleeping;
+
+  /*! @brief Should the engine thread stop? */
+  std::atomic<bool> _stop;
+
+  /*! @brief Mutex used to put the engine to sleep. */
+  std::mutex _sleep_mutex;
+
+  /*! @brief Condition variable used to wake up the engine. */
+  std::condition_variable _wake_up;
+
+  /*! @brief Number of commands that was handled (written by the engine). */
+  std::atomic<unsigned long> _number_of_commands;
+
+  /*! @brief Number of commands that was dropped because the command queue
+   *  was full (written by the user interface). */
+  std::atomic<unsigned long> _number_of_dropped_commands;
+
+  /*! @brief Total time commands spent in the command queue (in ns, written
+   *  by the engine). */
+  std::atomic<uint64_t> _total_command_latency;
+
+  /*! @brief Longest time a command spent in the command queue (in ns,
+   *  written by the engine). */
+  std::atomic<uint64_t> _max_command_latency;
+
+  /*! @brief Number of notifications that was received (written by the user
+   *  interface). */
+  std::atomic<unsigned long> _number_of_notifications;
+
+  /*! @brief Total time between sending a command and receiving the
+   *  corresponding notification (in ns, written by the user interface). */
+  std::atomic<uint64_t> _total_round_trip_latency;
+
+  /*! @brief Longest time between sending a command and receiving the
+   *  corresponding notification (in ns, written by the user interface). */
+  std::atomic<uint64_t> _max_round_trip_latency;
+
+  /*! @brief Engine thread. Declared last, so that it is started after all
+   *  other members were initialized. */
+  std::thread _thread;
+
+  void run();
+  void handle_command(const EngineCommand &command);
+
+public:
+  GameEngine(CardManager &card_manager, NotifyFunction notify_function = NULL,
+             void *notify_data = NULL);
+  ~GameEngine();
+
+  void stop();
+
+  static uint64_t now();
+
+  bool click_card(unsigned char index);
+  bool pop_notification(EngineNotification &notification);
+
+  uint32_t get_command_queue_depth() const;
+  uint32_t get_max_command_queue_depth() const;
+  uint32_t get_notification_queue_depth() const;
+  uint32_t get_max_notification_queue_depth() const;
+
+  unsigned long get_number_of_commands() const;
+  unsigned long get_number_of_dropped_commands() const;
+  double get_average_command_latency() const;
+  uint64_t get_max_command_latency() const;
+
+  unsigned long get_number_of_notifications() const;
+  double get_average_round_trip_latency() const;
+  uint64_t get_max_round_trip_latency() const;
+};
+
+#endif // OPENSET_GAMEENGINE_HPP
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file GameLog.hpp
+ *
+ * @brief Binary game log format.
+ *
+ * A game log consists of a GameLogHeader, followed by a stream of fixed width
+ * GameLogEvents. Checkpoint events are immediately followed by a raw copy of
+ * the GameState after the last complete move, so that a reader can verify its
+ * replay (or resume it) at regular intervals. The first event in a log is
+ * always a checkpoint.
+ *
+ * All values are stored in native byte order.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMELOG_HPP
+#define OPENSET_GAMELOG_HPP
+
+#include "CardIndex.hpp"
+#include "GameState.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Types of events in a game log.
+ */
+enum GameLogEventType {
+  /*! @brief A card was clicked (data: position on the main deck). */
+  GAMELOGEVENT_CLICK = 0,
+  /*! @brief The three clicked cards made up a set and were taken. */
+  GAMELOGEVENT_SET_FOUND,
+  /*! @brief The three clicked cards did not make up a set. */
+  GAMELOGEVENT_SET_REJECTED,
+  /*! @brief Extra cards were dealt (data: new size of the main deck). */
+  GAMELOGEVENT_DEAL,
+  /*! @brief Checkpoint: the event is followed by a GameState. */
+  GAMELOGEVENT_CHECKPOINT,
+  /*! @brief Counter. Should always be the last element! */
+  GAMELOGEVENT_COUNTER
+};
+
+/**
+ * @brief Header at the start of every game log.
+ */
+struct GameLogHeader {
+  /*! @brief Magic number at the start of every game log ("OSLG"). */
+  static const uint32_t MAGIC = 0x474c534fu;
+
+  /*! @brief Version of the game log format. */
+  static const uint16_t VERSION = 1;
+
+  /*! @brief Magic number (MAGIC). */
+  uint32_t _magic;
+
+  /*! @brief Version of the format (VERSION). */
+  uint16_t _version;
+
+  /*! @brief Number of moves between two checkpoints. */
+  uint16_t _checkpoint_interval;
+
+  /*! @brief Seed of the game. */
+  uint64_t _seed;
+
+  /*! @brief Order in which the cards are dealt. */
+  unsigned char _card_stack[CardIndex::CARDINDEX_COUNTER];
+
+  /*! @brief Padding up to a multiple of 8 bytes (always zero). */
+  unsigned char _padding[7];
+};
+
+/**
+ * @brief Single event in a game log.
+ */
+struct GameLogEvent {
+  /*! @brief Type of the event (a GameLogEventType). */
+  unsigned char _type;
+
+  /*! @brief Extra data, depending on the type of the event. */
+  unsigned char _data;
+};
+
+static_assert(sizeof(GameLogHeader) == 104,
+              "Unexpected size for the game log header!");
+static_assert(sizeof(GameLogEvent) == 2,
+              "Unexpected size for a game log event!");
+static_assert(sizeof(GameState) % sizeof(GameLogEvent) == 0,
+              "Checkpoints would break the alignment of the events!");
+
+#endif // OPENSET_GAMELOG_HPP
@@ -0,0 +1,286 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file GameLogReader.cpp
+ *
+ * @brief GameLogReader implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "GameLogReader.hpp"
+#include "CardManager.hpp"
+#include "CardMask.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Check if the given state, read from a log, is a state the game can
+ * actually be in.
+ *
+ * The log is untrusted input: a corrupt or tampered state could make the
+ * replay read or write outside the main deck.
+ *
+ * @param state GameState.
+ * @return True if the card stack contains every card exactly once, the main
+ * deck and the selection fit on the board, and the main deck only contains
+ * distinct cards that were already dealt.
+ */
+static bool is_valid_state(const GameState &state) {
+  if (state._main_deck_size > GameState::MAX_BOARD_SIZE ||
+      state._next_card > CardIndex::CARDINDEX_COUNTER ||
+      state._main_deck_size > state._next_card ||
+      (uint64_t(state._clicked) >> state._main_deck_size) != 0) {
+    return false;
+  }
+  CardMask stack;
+  CardMask dealt;
+  for (unsigned char i = 0; i < CardIndex::CARDINDEX_COUNTER; ++i) {
+    const unsigned char card = state._card_stack[i];
+    if (card >= CardIndex::CARDINDEX_COUNTER || stack.contains(card)) {
+      return false;
+    }
+    stack.add(card);
+    if (i < state._next_card) {
+      dealt.add(card);
+    }
+  }
+  CardMask main_deck;
+  for (unsigned char i = 0; i < state._main_deck_size; ++i) {
+    const unsigned char card = state._main_deck[i];
+    if (card >= CardIndex::CARDINDEX_COUNTER || !dealt.contains(card) ||
+        main_deck.contains(card)) {
+      return false;
+    }
+    main_deck.add(card);
+  }
+  return true;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Maps the given file into memory and checks its header.
+ *
+ * @param filename Name of the game log file.
+ */
+GameLogReader::GameLogReader(std::string filename)
+    : _data(NULL), _size(0), _valid(false) {
+  const int file_descriptor = open(filename.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    return;
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) == 0 &&
+      file_status.st_size >= static_cast<off_t>(sizeof(GameLogHeader))) {
+    void *data = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE,
+                      file_descriptor, 0);
+    if (data != MAP_FAILED) {
+      // events are read once, from front to back
+      madvise(data, file_status.st_size, MADV_SEQUENTIAL);
+      _data = static_cast<const unsigned char *>(data);
+      _size = file_status.st_size;
+    }
+  }
+  // the mapping stays valid after the file is closed
+  ::close(file_descriptor);
+
+  if (_data != NULL) {
+    const GameLogHeader &header = get_header();
+    _valid = (header._magic == GameLogHeader::MAGIC &&
+              header._version == GameLogHeader::VERSION);
+  }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Unmaps the file.
+ */
+GameLogReader::~GameLogReader() {
+  if (_data != NULL) {
+    munmap(const_cast<unsigned char *>(_data), _size);
+  }
+}
+
+/**
+ * @brief Check if the file was mapped and contains a valid header.
+ *
+ * @return True if the log can be replayed.
+ */
+bool GameLogReader::is_valid() const { return _valid; }
+
+/**
+ * @brief Get the header of the log.
+ *
+ * Should only be called if the file was mapped successfully.
+ *
+ * @return Reference to the header, inside the mapped file.
+ */
+const GameLogHeader &GameLogReader::get_header() const {
+  assert(_data != NULL);
+  return *reinterpret_cast<const GameLogHeader *>(_data);
+}
+
+/**
+ * @brief Replay the game in the log.
+ *
+ * The given CardManager is reset to the initial checkpoint in the log, so
+ * that logs that were started in the middle of a game can be replayed as
+ * well. All clicks in the log are then replayed. The replay fails as soon as
+ * the replayed game differs from the recorded game: if the card order does
+ * not match the header, if the initial checkpoint is not a valid state, if a
+ * click is invalid, if a recorded consequence of a click does not match the
+ * replayed consequence (including extra cards that were dealt or not dealt),
+ * or if the replayed state does not match a checkpoint.
+ *
+ * @param card_manager CardManager used for the replay. On return, it contains
+ * the state after the last event that was replayed successfully.
+ * @param number_of_events Number of events that was replayed successfully
+ * (optional).
+ * @return True if the entire log was replayed successfully.
+ */
+bool GameLogReader::replay(CardManager &card_manager,
+                           unsigned long *number_of_events) const {
+  if (number_of_events != NULL) {
+    *number_of_events = 0;
+  }
+  if (!_valid) {
+    return false;
+  }
+
+  const GameLogHeader &header = get_header();
+  const unsigned char *position = _data + sizeof(GameLogHeader);
+  const unsigned char *end = _data + _size;
+
+  // the log starts with a checkpoint of the game at the moment the recording
+  // started: we restore the game to that state
+  if (position + sizeof(GameLogEvent) + sizeof(GameState) > end ||
+      position[0] != GAMELOGEVENT_CHECKPOINT) {
+    return false;
+  }
+  GameState initial_state;
+  std::memcpy(&initial_state, position + sizeof(GameLogEvent),
+              sizeof(GameState));
+  if (std::memcmp(initial_state._card_stack, header._card_stack,
+                  CardIndex::CARDINDEX_COUNTER) != 0 ||
+      !is_valid_state(initial_state)) {
+    return false;
+  }
+  card_manager = CardManager(header._seed, initial_state);
+
+  // consequence of the last click that still needs to be confirmed by the log
+  // (GAMELOGEVENT_COUNTER if there is none)
+  unsigned char expected_outcome = GAMELOGEVENT_COUNTER;
+  // size of the main deck after the extra cards that were dealt by the last
+  // click, which the log still needs to confirm after the outcome (0 if no
+  // cards were dealt)
+  unsigned char expected_deal = 0;
+  unsigned long event_count = 0;
+  while (position + sizeof(GameLogEvent) <= end) {
+    GameLogEvent event;
+    std::memcpy(&event, position, sizeof(GameLogEvent));
+    position += sizeof(GameLogEvent);
+
+    const GameState &state = card_manager.get_state();
+    switch (event._type) {
+    case GAMELOGEVENT_CLICK: {
+      if (expected_outcome != GAMELOGEVENT_COUNTER || expected_deal != 0 ||
+          event._data >= state._main_deck_size) {
+        return false;
+      }
+      const unsigned char old_size = state._main_deck_size;
+      const unsigned char old_next_card = state._next_card;
+      // if this click selects a third card, the log should tell us whether
+      // it was a set
+      const uint32_t selection = state._clicked ^ (uint32_t(1) << event._data);
+      if (__builtin_popcount(selection) == 3) {
+        uint32_t remaining = selection;
+        unsigned char cards[3];
+        for (unsigned char i = 0; i < 3; ++i) {
+          cards[i] = state._main_deck[__builtin_ctz(remaining)];
+          remaining &= remaining - 1;
+        }
+        expected_outcome = CardIndex::is_set(cards[0], cards[1], cards[2])
+                               ? GAMELOGEVENT_SET_FOUND
+                               : GAMELOGEVENT_SET_REJECTED;
+      }
+      card_manager.click_card(event._data);
+      if (expected_outcome == GAMELOGEVENT_SET_FOUND) {
+        // a found set is replaced by new cards if the main deck is not
+        // larger than the base size, and is removed otherwise. Any card
+        // beyond that was dealt because the main deck had no set
+        unsigned char size = old_size - 3;
+        if (old_size <= CardManager::BASE_BOARD_SIZE) {
+          const unsigned char remaining_cards =
+              CardIndex::CARDINDEX_COUNTER - old_next_card;
+          size += remaining_cards < 3 ? remaining_cards : 3;
+        }
+        if (state._main_deck_size > size) {
+          expected_deal = state._main_deck_size;
+        }
+      }
+      break;
+    }
+    case GAMELOGEVENT_SET_FOUND:
+    case GAMELOGEVENT_SET_REJECTED:
+      if (event._type != expected_outcome) {
+        return false;
+      }
+      expected_outcome = GAMELOGEVENT_COUNTER;
+      break;
+    case GAMELOGEVENT_DEAL:
+      if (expected_outcome != GAMELOGEVENT_COUNTER || expected_deal == 0 ||
+          event._data != expected_deal) {
+        return false;
+      }
+      expected_deal = 0;
+      break;
+    case GAMELOGEVENT_CHECKPOINT: {
+      if (expected_outcome != GAMELOGEVENT_COUNTER || expected_deal != 0 ||
+          position + sizeof(GameState) > end) {
+        return false;
+      }
+      GameState checkpoint;
+      std::memcpy(&checkpoint, position, sizeof(GameState));
+      position += sizeof(GameState);
+      if (!(checkpoint == state)) {
+        return false;
+      }
+      break;
+    }
+    default:
+      return false;
+    }
+
+    ++event_count;
+    if (number_of_events != NULL) {
+      *number_of_events = event_count;
+    }
+  }
+  // a truncated event, a missing outcome or a missing deal means the log is
+  // incomplete
+  return position == end && expected_outcome == GAMELOGEVENT_COUNTER &&
+         expected_deal == 0;
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file GameLogReader.hpp
+ *
+ * @brief Memory mapped reader for binary game logs.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMELOGREADER_HPP
+#define OPENSET_GAMELOGREADER_HPP
+
+#include "GameLog.hpp"
+
+#include <cstddef>
+#include <string>
+
+class CardManager;
+
+/**
+ * @brief Memory mapped reader for binary game logs (see GameLog.hpp).
+ *
+ * The log file is mapped into memory (using POSIX mmap), so that events are
+ * read straight from the page cache without any copies or allocations. A
+ * replay feeds all clicks through a CardManager and checks every recorded
+ * consequence (accepted and rejected sets, extra deals) and every checkpoint
+ * against the replayed game.
+ */
+class GameLogReader {
+private:
+  /*! @brief Contents of the mapped file (NULL if the file could not be
+   *  mapped). */
+  const unsigned char *_data;
+
+  /*! @brief Size of the mapped file (in bytes). */
+  size_t _size;
+
+  /*! @brief Does the file contain a valid header? */
+  bool _valid;
+
+public:
+  GameLogReader(std::string filename);
+  ~GameLogReader();
+
+  // the mapping cannot be shared between readers
+  GameLogReader(const GameLogReader &) = delete;
+  GameLogReader &operator=(const GameLogReader &) = delete;
+
+  bool is_valid() const;
+  const GameLogHeader &get_header() const;
+
+  bool replay(CardManager &card_manager,
+              unsigned long *number_of_events = NULL) const;
+};
+
+#endif // OPENSET_GAMELOGREADER_HPP
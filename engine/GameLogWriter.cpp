@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file GameLogWriter.cpp
+ *
+ * @brief GameLogWriter implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "GameLogWriter.hpp"
+
+#include <cassert>
+#include <cstring>
+
+/**
+ * @brief Constructor.
+ *
+ * @param filename Name of the game log file (an existing file is
+ * overwritten).
+ * @param checkpoint_interval Number of moves between two checkpoints.
+ */
+GameLogWriter::GameLogWriter(std::string filename,
+                             uint16_t checkpoint_interval)
+    : _file(filename, std::ios::binary | std::ios::trunc),
+      _checkpoint_interval(checkpoint_interval), _moves_since_checkpoint(0),
+      _number_of_events(0), _last_state(), _started(false) {
+  assert(checkpoint_interval > 0);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Closes the log, if this was not done before.
+ */
+GameLogWriter::~GameLogWriter() { close(); }
+
+/**
+ * @brief Check if the game log file was opened successfully.
+ *
+ * @return True if events can be written to the log.
+ */
+bool GameLogWriter::is_open() const { return _file.is_open() && _file.good(); }
+
+/**
+ * @brief Get the number of events that was written, including checkpoints.
+ *
+ * @return Number of events.
+ */
+unsigned long GameLogWriter::get_number_of_events() const {
+  return _number_of_events;
+}
+
+/**
+ * @brief Start recording a game.
+ *
+ * Writes the header and an initial checkpoint. This function can only be
+ * called once per log.
+ *
+ * @param seed Seed of the game.
+ * @param state Current state of the game.
+ */
+void GameLogWriter::begin(uint64_t seed, const GameState &state) {
+  assert(!_started);
+  _started = true;
+
+  GameLogHeader header = GameLogHeader();
+  header._magic = GameLogHeader::MAGIC;
+  header._version = GameLogHeader::VERSION;
+  header._checkpoint_interval = _checkpoint_interval;
+  header._seed = seed;
+  for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER; ++card) {
+    header._card_stack[card] = state._card_stack[card];
+  }
+  _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  write_checkpoint(state);
+}
+
+/**
+ * @brief Record a single event.
+ *
+ * @param type Type of the event (should not be a checkpoint).
+ * @param data Extra data for the event.
+ */
+void GameLogWriter::record(GameLogEventType type, unsigned char data) {
+  assert(_started && type != GAMELOGEVENT_CHECKPOINT);
+  write_event(type, data);
+}
+
+/**
+ * @brief Signal the end of a complete move (a click and all of its
+ * consequences).
+ *
+ * Writes a checkpoint if checkpoint_interval moves were recorded since the
+ * last checkpoint.
+ *
+ * @param state State of the game after the move.
+ */
+void GameLogWriter::end_move(const GameState &state) {
+  assert(_started);
+  _last_state = state;
+  ++_moves_since_checkpoint;
+  if (_moves_since_checkpoint == _checkpoint_interval) {
+    write_checkpoint(state);
+  }
+}
+
+/**
+ * @brief Write a final checkpoint (if moves were recorded since the last one)
+ * and close the log.
+ */
+void GameLogWriter::close() {
+  if (!_file.is_open()) {
+    return;
+  }
+  if (_started && _moves_since_checkpoint > 0) {
+    write_checkpoint(_last_state);
+  }
+  _file.close();
+}
+
+/**
+ * @brief Write a single event to the log.
+ *
+ * @param type Type of the event.
+ * @param data Extra data for the event.
+ */
+void GameLogWriter::write_event(GameLogEventType type, unsigned char data) {
+  GameLogEvent event;
+  event._type = type;
+  event._data = data;
+  _file.write(reinterpret_cast<const char *>(&event), sizeof(event));
+  ++_number_of_events;
+}
+
+/**
+ * @brief Write a checkpoint event, followed by the given state.
+ *
+ * @param state State of the game.
+ */
+void GameLogWriter::write_checkpoint(const GameState &state) {
+  write_event(GAMELOGEVENT_CHECKPOINT, 0);
+  // copy the state member by member, so that no uninitialized padding bytes
+  // end up in the log
+  GameState copy = GameState();
+  std::memcpy(copy._card_stack, state._card_stack, sizeof(copy._card_stack));
+  std::memcpy(copy._main_deck, state._main_deck, sizeof(copy._main_deck));
+  copy._main_deck_size = state._main_deck_size;
+  copy._next_card = state._next_card;
+  copy._clicked = state._clicked;
+  _file.write(reinterpret_cast<const char *>(&copy), sizeof(copy));
+  _moves_since_checkpoint = 0;
+  _last_state = state;
+}
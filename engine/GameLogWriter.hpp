@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file GameLogWriter.hpp
+ *
+ * @brief Recorder that writes the events of a game to a binary game log.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMELOGWRITER_HPP
+#define OPENSET_GAMELOGWRITER_HPP
+
+#include "GameLog.hpp"
+
+#include <fstream>
+#include <string>
+
+/**
+ * @brief Recorder that writes the events of a game to a binary game log (see
+ * GameLog.hpp).
+ *
+ * The writer is attached to a CardManager using CardManager::set_recorder(),
+ * after which every click, every accepted or rejected set and every deal of
+ * extra cards is written as a single 2 byte event. A checkpoint is written
+ * after every checkpoint_interval moves, and when the log is closed.
+ */
+class GameLogWriter {
+private:
+  /*! @brief Output file. */
+  std::ofstream _file;
+
+  /*! @brief Number of moves between two checkpoints. */
+  const uint16_t _checkpoint_interval;
+
+  /*! @brief Number of moves since the last checkpoint. */
+  unsigned int _moves_since_checkpoint;
+
+  /*! @brief Number of events that was written. */
+  unsigned long _number_of_events;
+
+  /*! @brief State of the game after the last complete move. */
+  GameState _last_state;
+
+  /*! @brief Has a game been started? */
+  bool _started;
+
+public:
+  GameLogWriter(std::string filename, uint16_t checkpoint_interval = 256);
+  ~GameLogWriter();
+
+  bool is_open() const;
+  unsigned long get_number_of_events() const;
+
+  void begin(uint64_t seed, const GameState &state);
+  void record(GameLogEventType type, unsigned char data);
+  void end_move(const GameState &state);
+  void close();
+
+private:
+  void write_event(GameLogEventType type, unsigned char data);
+  void write_checkpoint(const GameState &state);
+};
+
+#endif // OPENSET_GAMELOGWRITER_HPP
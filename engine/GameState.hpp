@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file GameState.hpp
+ *
+ * @brief Compact representation of the mutable state of a single game.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMESTATE_HPP
+#define OPENSET_GAMESTATE_HPP
+
+#include "CardIndex.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Compact representation of the mutable state of a single game.
+ *
+ * The properties of the cards themselves never change and are stored in a
+ * single table shared by all games (see Card::get_card()), so that a game only
+ * needs to keep track of card indices. The state is a plain old data structure
+ * without pointers that fits in two cache lines, so that it can be copied
+ * using memcpy and a single process can host a very large number of games.
+ */
+struct GameState {
+  /*! @brief Maximum number of cards on the main deck. */
+  static const unsigned char MAX_BOARD_SIZE = 18;
+
+  /*! @brief Shuffled indices of all cards: the order in which cards are
+   *  dealt. */
+  unsigned char _card_stack[CardIndex::CARDINDEX_COUNTER];
+
+  /*! @brief Indices of the cards on the main deck. */
+  unsigned char _main_deck[MAX_BOARD_SIZE];
+
+  /*! @brief Number of cards on the main deck. */
+  unsigned char _main_deck_size;
+
+  /*! @brief Index of the next card in the card stack that should be added to
+   *  the main deck. */
+  unsigned char _next_card;
+
+  /*! @brief Selection: bit i is set if the card with index i on the main deck
+   *  is clicked. */
+  uint32_t _clicked;
+};
+
+/**
+ * @brief Compare two game states.
+ *
+ * The members are compared one by one, so that padding bytes are ignored.
+ *
+ * @param state1 First GameState.
+ * @param state2 Second GameState.
+ * @return True if both states are exactly the same.
+ */
+inline bool operator==(const GameState &state1, const GameState &state2) {
+  return std::memcmp(state1._card_stack, state2._card_stack,
+                     sizeof(state1._card_stack)) == 0 &&
+         std::memcmp(state1._main_deck, state2._main_deck,
+                     sizeof(state1._main_deck)) == 0 &&
+         state1._main_deck_size == state2._main_deck_size &&
+         state1._next_card == state2._next_card &&
+         state1._clicked == state2._clicked;
+}
+
+static_assert(sizeof(GameState) <= 128,
+              "GameState should fit in two cache lines!");
+static_assert(GameState::MAX_BOARD_SIZE <= 32,
+              "The selection mask cannot hold all cards on the main deck!");
+
+#endif // OPENSET_GAMESTATE_HPP
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file RandomGenerator.hpp
+ *
+ * @brief Small and fast seedable pseudo-random number generator.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_RANDOMGENERATOR_HPP
+#define OPENSET_RANDOMGENERATOR_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Small and fast seedable pseudo-random number generator.
+ *
+ * Implementation of the PCG32 generator (XSH RR variant) of O'Neill (2014):
+ * a 64-bit linear congruential generator whose output is scrambled by a
+ * permutation of the high bits. The full state is a single 64-bit integer, so
+ * that every game can cheaply own its own generator.
+ */
+class RandomGenerator {
+private:
+  /*! @brief Internal state of the linear congruential generator. */
+  uint64_t _state;
+
+  /**
+   * @brief Advance the internal state of the linear congruential generator.
+   */
+  inline void step() {
+    _state = _state * 6364136223846793005ull + 1442695040888963407ull;
+  }
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * The seed is first scrambled using the SplitMix64 finalizer, so that
+   * consecutive seeds give unrelated random sequences.
+   *
+   * @param seed Seed for the random sequence.
+   */
+  inline RandomGenerator(uint64_t seed) {
+    seed += 0x9e3779b97f4a7c15ull;
+    seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ull;
+    seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebull;
+    _state = seed ^ (seed >> 31);
+    step();
+  }
+
+  /**
+   * @brief Get a uniform random 32-bit integer.
+   *
+   * @return Random integer in the range [0, 2^32[.
+   */
+  inline uint32_t get_random_integer() {
+    const uint64_t old_state = _state;
+    step();
+    const uint32_t xorshifted =
+        static_cast<uint32_t>(((old_state >> 18) ^ old_state) >> 27);
+    const uint32_t rotation = static_cast<uint32_t>(old_state >> 59);
+    return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31));
+  }
+
+  /**
+   * @brief Get a uniform random integer in the range [0, bound[.
+   *
+   * Uses the multiply-and-shift method of Lemire (2019), with rejection of
+   * the few values that would introduce a bias.
+   *
+   * @param bound Upper limit (not included) of the range (should be > 0).
+   * @return Unbiased random integer in the range [0, bound[.
+   */
+  inline uint32_t get_random_integer(uint32_t bound) {
+    uint64_t product = uint64_t(get_random_integer()) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+      const uint32_t threshold = (-bound) % bound;
+      while (low < threshold) {
+        product = uint64_t(get_random_integer()) * bound;
+        low = static_cast<uint32_t>(product);
+      }
+    }
+    return static_cast<uint32_t>(product >> 32);
+  }
+
+  /**
+   * @brief Randomly shuffle the given array in place.
+   *
+   * Fisher-Yates shuffle: every permutation is equally likely.
+   *
+   * @param array Array to shuffle.
+   * @param size Number of elements in the array.
+   */
+  template <typename _type_>
+  inline void shuffle(_type_ *array, uint32_t size) {
+    for (uint32_t i = size; i > 1; --i) {
+      const uint32_t j = get_random_integer(i);
+      const _type_ tmp = array[i - 1];
+      array[i - 1] = array[j];
+      array[j] = tmp;
+    }
+  }
+};
+
+#endif // OPENSET_RANDOMGENERATOR_HPP
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file SPSCQueue.hpp
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_SPSCQUEUE_HPP
+#define OPENSET_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * Exactly one thread can push elements, and exactly one (other) thread can pop
+ * them. Neither operation ever blocks: pushing to a full queue and popping
+ * from an empty queue simply fail. The positions of both threads are stored
+ * on separate cache lines, and every thread keeps a cached copy of the
+ * position of the other thread, so that the shared positions are only read
+ * when the cached copy suggests the queue is full (or empty).
+ *
+ * The producer also keeps track of the largest number of elements that was
+ * ever in the queue.
+ *
+ * @tparam _type_ Type of the elements. Should be trivially copyable.
+ * @tparam _capacity_ Maximum number of elements in the queue. Should be a
+ * power of 2.
+ */
+template <typename _type_, uint32_t _capacity_> class SPSCQueue {
+private:
+  static_assert(_capacity_ > 0 && (_capacity_ & (_capacity_ - 1)) == 0,
+                "The capacity of an SPSCQueue should be a power of 2!");
+
+  /*! @brief Position of the next element that will be pushed. Only written
+   *  by the producer. */
+  alignas(64) std::atomic<uint32_t> _tail;
+
+  /*! @brief Last position of the consumer seen by the producer. */
+  uint32_t _cached_head;
+
+  /*! @brief Largest number of elements that was in the queue. */
+  std::atomic<uint32_t> _max_size;
+
+  /*! @brief Position of the next element that will be popped. Only written by
+   *  the consumer. */
+  alignas(64) std::atomic<uint32_t> _head;
+
+  /*! @brief Last position of the producer seen by the consumer. */
+  uint32_t _cached_tail;
+
+  /*! @brief Elements. */
+  alignas(64) _type_ _elements[_capacity_];
+
+public:
+  /**
+   * @brief Empty constructor.
+   */
+  inline SPSCQueue()
+      : _tail(0), _cached_head(0), _max_size(0), _head(0), _cached_tail(0) {}
+
+  /**
+   * @brief Add an element to the queue (producer only).
+   *
+   * @param element Element to add.
+   * @return True on success, false if the queue is full.
+   */
+  inline bool try_push(const _type_ &element) {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _cached_head == _capacity_) {
+      _cached_head = _head.load(std::memory_order_acquire);
+      if (tail - _cached_head == _capacity_) {
+        return false;
+      }
+    }
+    _elements[tail & (_capacity_ - 1)] = element;
+    _tail.store(tail + 1, std::memory_order_release);
+    const uint32_t size = tail + 1 - _cached_head;
+    if (size > _max_size.load(std::memory_order_relaxed)) {
+      _max_size.store(size, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Remove the oldest element from the queue (consumer only).
+   *
+   * @param element Variable to store the element in.
+   * @return True on success, false if the queue is empty.
+   */
+  inline bool try_pop(_type_ &element) {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head == _cached_tail) {
+      _cached_tail = _tail.load(std::memory_order_acquire);
+      if (head == _cached_tail) {
+        return false;
+      }
+    }
+    element = _elements[head & (_capacity_ - 1)];
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Get the number of elements in the queue.
+   *
+   * The result is exact if no other thread changes the queue, and an
+   * approximation otherwise. Can be called by any thread.
+   *
+   * @return Number of elements in the queue.
+   */
+  inline uint32_t size() const {
+    const uint32_t head = _head.load(std::memory_order_acquire);
+    const uint32_t tail = _tail.load(std::memory_order_acquire);
+    return tail - head;
+  }
+
+  /**
+   * @brief Check if the queue is empty.
+   *
+   * @return True if the queue contains no elements.
+   */
+  inline bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Get the largest number of elements that was ever in the queue.
+   *
+   * The size is measured by the producer right after an element was pushed,
+   * using the last position of the consumer it has seen, so this is an upper
+   * bound.
+   *
+   * @return Largest number of elements in the queue.
+   */
+  inline uint32_t get_max_size() const {
+    return _max_size.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the maximum number of elements in the queue.
+   *
+   * @return Capacity of the queue.
+   */
+  inline static constexpr uint32_t get_capacity() { return _capacity_; }
+};
+
+#endif // OPENSET_SPSCQUEUE_HPP
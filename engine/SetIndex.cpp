@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file SetIndex.cpp
+ *
+ * @brief SetIndex implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "SetIndex.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Constructor.
+ *
+ * Creates an index for an empty board.
+ */
+SetIndex::SetIndex() : _number_of_sets(0) {}
+
+/**
+ * @brief Reset the index to the given board.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ */
+void SetIndex::rebuild(const unsigned char *board, unsigned char board_size) {
+  assert(board_size <= GameState::MAX_BOARD_SIZE);
+
+  _cards = CardMask();
+  _number_of_sets = 0;
+  for (unsigned char i = 0; i < board_size; ++i) {
+    add_card(board[i]);
+  }
+}
+
+/**
+ * @brief Add the given card to the board.
+ *
+ * Every set that contains the new card consists of the new card and a pair of
+ * cards that were already on the board. For every card on the board, we look
+ * up the card that completes the set with the new card. To find every set only
+ * once, we only accept the set if that card has a higher index. This requires
+ * a single pass over the board.
+ *
+ * @param card Index of a card that is not on the board yet.
+ */
+void SetIndex::add_card(unsigned char card) {
+  assert(!_cards.contains(card));
+
+  for (unsigned char word = 0; word < 2; ++word) {
+    uint64_t bits = _cards.get_word(word);
+    while (bits != 0) {
+      const unsigned char other = 64 * word + __builtin_ctzll(bits);
+      bits &= bits - 1;
+      const unsigned char third = CardIndex::get_third_card(card, other);
+      if (third > other && _cards.contains(third)) {
+        assert(_number_of_sets < MAX_NUMBER_OF_SETS);
+        unsigned char *set = _sets + 3 * _number_of_sets;
+        // other < third: insert card at the right position
+        if (card < other) {
+          set[0] = card;
+          set[1] = other;
+          set[2] = third;
+        } else if (card < third) {
+          set[0] = other;
+          set[1] = card;
+          set[2] = third;
+        } else {
+          set[0] = other;
+          set[1] = third;
+          set[2] = card;
+        }
+        ++_number_of_sets;
+      }
+    }
+  }
+  _cards.add(card);
+}
+
+/**
+ * @brief Remove the given card from the board.
+ *
+ * All sets that contain the card are removed from the index. The last set in
+ * the index takes the place of a removed set, so that this only requires a
+ * single pass over the sets.
+ *
+ * @param card Index of a card on the board.
+ */
+void SetIndex::remove_card(unsigned char card) {
+  assert(_cards.contains(card));
+
+  _cards.remove(card);
+  unsigned char set = 0;
+  while (set < _number_of_sets) {
+    const unsigned char *cards = _sets + 3 * set;
+    if (cards[0] == card || cards[1] == card || cards[2] == card) {
+      --_number_of_sets;
+      _sets[3 * set] = _sets[3 * _number_of_sets];
+      _sets[3 * set + 1] = _sets[3 * _number_of_sets + 1];
+      _sets[3 * set + 2] = _sets[3 * _number_of_sets + 2];
+    } else {
+      ++set;
+    }
+  }
+}
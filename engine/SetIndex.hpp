@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file SetIndex.hpp
+ *
+ * @brief Live index of the sets on a board.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_SETINDEX_HPP
+#define OPENSET_SETINDEX_HPP
+
+#include "CardIndex.hpp"
+#include "CardMask.hpp"
+#include "GameState.hpp"
+
+/**
+ * @brief Live index of the sets on a board.
+ *
+ * The index keeps track of the cards on the board and of all the sets these
+ * cards make up. Sets are stored as card indices (and not as board positions),
+ * so that they stay valid when cards are moved on the board. Adding or
+ * removing a single card only updates the sets that contain that card, which
+ * is much cheaper than searching the entire board again after every move.
+ */
+class SetIndex {
+public:
+  /*! @brief Maximum number of sets on a board with MAX_BOARD_SIZE cards:
+   *  every pair of cards belongs to at most one set. */
+  static const unsigned char MAX_NUMBER_OF_SETS =
+      GameState::MAX_BOARD_SIZE * (GameState::MAX_BOARD_SIZE - 1) / 6;
+
+private:
+  /*! @brief Cards on the board. */
+  CardMask _cards;
+
+  /*! @brief Sets on the board: set i consists of the cards with indices
+   *  3*i, 3*i+1 and 3*i+2 (in increasing order). */
+  unsigned char _sets[3 * MAX_NUMBER_OF_SETS];
+
+  /*! @brief Number of sets on the board. */
+  unsigned char _number_of_sets;
+
+public:
+  SetIndex();
+
+  void rebuild(const unsigned char *board, unsigned char board_size);
+  void add_card(unsigned char card);
+  void remove_card(unsigned char card);
+
+  /**
+   * @brief Get the number of sets on the board.
+   *
+   * @return Number of sets on the board.
+   */
+  inline unsigned char set_count() const { return _number_of_sets; }
+
+  /**
+   * @brief Get the set with the given index.
+   *
+   * The order of the sets changes when cards are added or removed.
+   *
+   * @param set Index of a set, should be smaller than set_count().
+   * @return Pointer to the indices of the three cards that make up the set (in
+   * increasing order).
+   */
+  inline const unsigned char *get_set(unsigned char set) const {
+    return _sets + 3 * set;
+  }
+
+  /**
+   * @brief Get the cards that are on the board.
+   *
+   * @return Membership mask of the cards on the board.
+   */
+  inline const CardMask &get_cards() const { return _cards; }
+};
+
+#endif // OPENSET_SETINDEX_HPP
@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file SetRules.hpp
+ *
+ * @brief Set rules for decks with an arbitrary number of attributes.
+ *
+ * A deck with @f$N@f$ attributes that each take 3 values contains @f$3^N@f$
+ * cards. Every card is encoded as an index with @f$N@f$ base-3 digits, one for
+ * every attribute, so that three cards make up a set if the sum of every digit
+ * is a multiple of 3. The classic game (see CardIndex.hpp) has 4 attributes.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_SETRULES_HPP
+#define OPENSET_SETRULES_HPP
+
+#include <cassert>
+#include <cstdint>
+
+/**
+ * @brief Get the number of cards in a deck with the given number of
+ * attributes.
+ *
+ * @param number_of_attributes Number of attributes.
+ * @return 3 to the power number_of_attributes.
+ */
+constexpr unsigned int
+get_number_of_cards(unsigned char number_of_attributes) {
+  return number_of_attributes == 0
+             ? 1
+             : 3 * get_number_of_cards(number_of_attributes - 1);
+}
+
+/**
+ * @brief Table containing the index of the card that completes the set for
+ * every pair of cards in a deck with the given number of attributes.
+ *
+ * The table is fully computed at compile time.
+ */
+template <unsigned char _number_of_attributes_> class ThirdCardTable {
+public:
+  /*! @brief Number of cards in the deck. */
+  static const unsigned int CARD_COUNTER =
+      get_number_of_cards(_number_of_attributes_);
+
+private:
+  /*! @brief Index of the third card for every pair of card indices. */
+  unsigned char _third_card[CARD_COUNTER][CARD_COUNTER];
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * Fills the table one base-3 digit at a time: the digit of the third card
+   * is the digit that makes the sum of the three digits a multiple of 3.
+   */
+  constexpr ThirdCardTable() : _third_card{} {
+    for (unsigned int card1 = 0; card1 < CARD_COUNTER; ++card1) {
+      for (unsigned int card2 = 0; card2 < CARD_COUNTER; ++card2) {
+        unsigned int third_card = 0;
+        unsigned int digit_value = 1;
+        unsigned int index1 = card1;
+        unsigned int index2 = card2;
+        for (unsigned char digit = 0; digit < _number_of_attributes_;
+             ++digit) {
+          third_card += digit_value * ((6 - index1 % 3 - index2 % 3) % 3);
+          index1 /= 3;
+          index2 /= 3;
+          digit_value *= 3;
+        }
+        _third_card[card1][card2] = third_card;
+      }
+    }
+  }
+
+  /**
+   * @brief Get the index of the card that completes the set for the given
+   * pair of cards.
+   *
+   * @param card1 Index of the first card.
+   * @param card2 Index of the second card.
+   * @return Index of the third card.
+   */
+  constexpr unsigned char get_third_card(unsigned char card1,
+                                         unsigned char card2) const {
+    return _third_card[card1][card2];
+  }
+};
+
+/**
+ * @brief Set rules for a deck with the given number of attributes.
+ *
+ * All sizes are compile time constants, so that every deck gets its own
+ * fixed size storage and third card table, and the classic game (4
+ * attributes) compiles down to exactly the same code as a hand-written
+ * version.
+ *
+ * Card indices and board positions are stored as unsigned chars, which
+ * limits the number of attributes to 5 (243 cards).
+ */
+template <unsigned char _number_of_attributes_> class SetRules {
+public:
+  static_assert(_number_of_attributes_ > 0 && _number_of_attributes_ <= 5,
+                "Only decks with 1 to 5 attributes are supported!");
+
+  /*! @brief Number of attributes. */
+  static const unsigned char NUMBER_OF_ATTRIBUTES = _number_of_attributes_;
+
+  /*! @brief Number of values every attribute can take. */
+  static const unsigned char NUMBER_OF_VALUES = 3;
+
+  /*! @brief Number of cards in the deck. */
+  static const unsigned int CARD_COUNTER =
+      get_number_of_cards(_number_of_attributes_);
+
+  /*! @brief Number of 64-bit words in a membership mask over all cards. */
+  static const unsigned int MASK_SIZE = (CARD_COUNTER + 63) / 64;
+
+  /*! @brief Third card table. */
+  static constexpr ThirdCardTable<_number_of_attributes_> THIRD_CARD_TABLE{};
+
+  /**
+   * @brief Get the index of the card with the given attribute values.
+   *
+   * @param values Values of all attributes (0-2), starting with the attribute
+   * that corresponds to the least significant digit.
+   * @return Index of the card.
+   */
+  static constexpr unsigned char get_index(const unsigned char *values) {
+    unsigned int index = 0;
+    for (unsigned char attribute = NUMBER_OF_ATTRIBUTES; attribute > 0;
+         --attribute) {
+      index = 3 * index + values[attribute - 1];
+    }
+    return index;
+  }
+
+  /**
+   * @brief Get the value of the given attribute for the card with the given
+   * index.
+   *
+   * @param index Index of a card.
+   * @param attribute Attribute (0 corresponds to the least significant
+   * digit).
+   * @return Value of the attribute (0-2).
+   */
+  static constexpr unsigned char get_value(unsigned char index,
+                                           unsigned char attribute) {
+    return (index / get_number_of_cards(attribute)) % 3;
+  }
+
+  /**
+   * @brief Get the index of the card that completes the set for the given
+   * pair of cards.
+   *
+   * @param card1 Index of the first card.
+   * @param card2 Index of the second card.
+   * @return Index of the third card.
+   */
+  static inline unsigned char get_third_card(unsigned char card1,
+                                             unsigned char card2) {
+    return THIRD_CARD_TABLE.get_third_card(card1, card2);
+  }
+
+  /**
+   * @brief Check if the three cards with the given indices make up a set.
+   *
+   * @param card1 Index of the first card.
+   * @param card2 Index of the second card.
+   * @param card3 Index of the third card.
+   * @return True if the three cards make up a set.
+   */
+  static inline bool is_set(unsigned char card1, unsigned char card2,
+                            unsigned char card3) {
+    return THIRD_CARD_TABLE.get_third_card(card1, card2) == card3;
+  }
+
+  /**
+   * @brief Find all sets on the given board.
+   *
+   * We visit every pair of cards once, and look up the card that completes
+   * the set for that pair in the third card table. A membership mask over all
+   * cards then tells us if that card is on the board. To make sure every set
+   * is only found once, we only accept the set if the third card comes after
+   * the pair on the board. No memory is allocated.
+   *
+   * @param board Indices of distinct cards on the board.
+   * @param board_size Number of cards on the board.
+   * @param sets Buffer to store the sets in. Should be large enough to hold
+   * board_size * (board_size - 1) / 2 indices. Set i is stored in elements
+   * 3*i, 3*i+1 and 3*i+2, as positions on the board (in increasing order).
+   * @return Number of sets that was found.
+   */
+  static unsigned int find_all_sets(const unsigned char *board,
+                                    unsigned int board_size,
+                                    unsigned char *sets) {
+    assert(board_size <= CARD_COUNTER);
+
+    // board position of every card on the board; positions for cards that are
+    // not on the board are never read
+    unsigned char position[CARD_COUNTER];
+    uint64_t mask[MASK_SIZE] = {};
+    for (unsigned int i = 0; i < board_size; ++i) {
+      mask[board[i] >> 6] |= uint64_t(1) << (board[i] & 63);
+      position[board[i]] = i;
+    }
+
+    unsigned int number_of_sets = 0;
+    for (unsigned int i = 0; i + 2 < board_size; ++i) {
+      for (unsigned int j = i + 1; j + 1 < board_size; ++j) {
+        const unsigned char third_card = get_third_card(board[i], board[j]);
+        if (((mask[third_card >> 6] >> (third_card & 63)) & 1) &&
+            position[third_card] > j) {
+          sets[3 * number_of_sets] = i;
+          sets[3 * number_of_sets + 1] = j;
+          sets[3 * number_of_sets + 2] = position[third_card];
+          ++number_of_sets;
+        }
+      }
+    }
+    return number_of_sets;
+  }
+
+  /**
+   * @brief Count the number of sets on the given board.
+   *
+   * Same algorithm as find_all_sets(), but without storing the sets.
+   *
+   * @param board Indices of distinct cards on the board.
+   * @param board_size Number of cards on the board.
+   * @return Number of sets on the board.
+   */
+  static unsigned int count_sets(const unsigned char *board,
+                                 unsigned int board_size) {
+    assert(board_size <= CARD_COUNTER);
+
+    uint64_t mask[MASK_SIZE] = {};
+    for (unsigned int i = 0; i < board_size; ++i) {
+      mask[board[i] >> 6] |= uint64_t(1) << (board[i] & 63);
+    }
+
+    // every set is found once for each of its 3 pairs
+    unsigned int number_of_pairs = 0;
+    for (unsigned int i = 0; i + 1 < board_size; ++i) {
+      for (unsigned int j = i + 1; j < board_size; ++j) {
+        const unsigned char third_card = get_third_card(board[i], board[j]);
+        number_of_pairs += (mask[third_card >> 6] >> (third_card & 63)) & 1;
+      }
+    }
+    return number_of_pairs / 3;
+  }
+
+  /**
+   * @brief Check if the given board contains at least one set.
+   *
+   * Same algorithm as find_all_sets(), but we stop as soon as a set is found.
+   *
+   * @param board Indices of distinct cards on the board.
+   * @param board_size Number of cards on the board.
+   * @return True if there is a set on the board.
+   */
+  static bool has_set(const unsigned char *board, unsigned int board_size) {
+    assert(board_size <= CARD_COUNTER);
+
+    uint64_t mask[MASK_SIZE] = {};
+    for (unsigned int i = 0; i < board_size; ++i) {
+      mask[board[i] >> 6] |= uint64_t(1) << (board[i] & 63);
+    }
+
+    for (unsigned int i = 0; i + 2 < board_size; ++i) {
+      for (unsigned int j = i + 1; j + 1 < board_size; ++j) {
+        const unsigned char third_card = get_third_card(board[i], board[j]);
+        if ((mask[third_card >> 6] >> (third_card & 63)) & 1) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+};
+
+/*! @brief Definition of the third card table (required for ODR-use). */
+template <unsigned char _number_of_attributes_>
+constexpr ThirdCardTable<_number_of_attributes_>
+    SetRules<_number_of_attributes_>::THIRD_CARD_TABLE;
+
+#endif // OPENSET_SETRULES_HPP
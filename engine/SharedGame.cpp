@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file SharedGame.cpp
+ *
+ * @brief SharedGame implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "SharedGame.hpp"
+
+#include <cassert>
+#include <cstring>
+
+/**
+ * @brief Constructor.
+ *
+ * @param seed Seed for the random generator used to shuffle the cards.
+ */
+SharedGame::SharedGame(uint64_t seed) : _version(0), _card_manager(seed) {
+  publish();
+}
+
+/**
+ * @brief Copy the main deck of the game into the published board words.
+ *
+ * Should only be called by the constructor or by the winner of a claim, while
+ * the version is odd.
+ */
+void SharedGame::publish() {
+  const GameState &state = _card_manager.get_state();
+  unsigned char bytes[NUMBER_OF_BOARD_WORDS * sizeof(uint64_t)] = {0};
+  std::memcpy(bytes, state._main_deck, GameState::MAX_BOARD_SIZE);
+  bytes[GameState::MAX_BOARD_SIZE] = state._main_deck_size;
+  bytes[GameState::MAX_BOARD_SIZE + 1] = state._next_card;
+  bytes[GameState::MAX_BOARD_SIZE + 2] = _card_manager.set_count();
+  for (unsigned char i = 0; i < NUMBER_OF_BOARD_WORDS; ++i) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+    _board[i].store(word, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Take a consistent snapshot of the board.
+ *
+ * The board words are copied between two reads of the version. If a claim was
+ * processed in between, the copy is discarded and we try again. This function
+ * is lock-free and can be called by any number of threads.
+ *
+ * @return Snapshot of the board, with the version it belongs to.
+ */
+SharedBoard SharedGame::read() const {
+  unsigned char bytes[NUMBER_OF_BOARD_WORDS * sizeof(uint64_t)];
+  uint64_t version;
+  while (true) {
+    version = _version.load(std::memory_order_acquire);
+    if (version & 1) {
+      continue;
+    }
+    for (unsigned char i = 0; i < NUMBER_OF_BOARD_WORDS; ++i) {
+      const uint64_t word = _board[i].load(std::memory_order_relaxed);
+      std::memcpy(bytes + i * sizeof(uint64_t), &word, sizeof(uint64_t));
+    }
+    // make sure the board words are read before the version is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_version.load(std::memory_order_relaxed) == version) {
+      break;
+    }
+  }
+
+  SharedBoard board;
+  board._version = version;
+  std::memcpy(board._main_deck, bytes, GameState::MAX_BOARD_SIZE);
+  board._main_deck_size = bytes[GameState::MAX_BOARD_SIZE];
+  board._next_card = bytes[GameState::MAX_BOARD_SIZE + 1];
+  board._set_count = bytes[GameState::MAX_BOARD_SIZE + 2];
+  return board;
+}
+
+/**
+ * @brief Try to take the set at the given positions.
+ *
+ * The set is checked on the given snapshot. If the snapshot is still the
+ * current board, the check is also valid for the game itself. A claim never
+ * waits: if another player is processing a claim or already took a set, the
+ * claim is rejected as stale, and the player should read() the board again.
+ *
+ * @param board Snapshot of the board, as returned by read().
+ * @param positions Positions of three cards on the snapshot.
+ * @return SHAREDGAMECLAIM_WON if the set was taken by this claim,
+ * SHAREDGAMECLAIM_STALE if the board changed since the snapshot was taken,
+ * SHAREDGAMECLAIM_INVALID if the cards do not make up a set.
+ */
+SharedGameClaimResult SharedGame::claim(const SharedBoard &board,
+                                        const unsigned char *positions) {
+  if (positions[0] >= board._main_deck_size ||
+      positions[1] >= board._main_deck_size ||
+      positions[2] >= board._main_deck_size ||
+      positions[0] == positions[1] || positions[0] == positions[2] ||
+      positions[1] == positions[2] ||
+      !CardIndex::is_set(board._main_deck[positions[0]],
+                         board._main_deck[positions[1]],
+                         board._main_deck[positions[2]])) {
+    return SHAREDGAMECLAIM_INVALID;
+  }
+
+  // cheap check first: a failed compare-and-swap still takes the cache line
+  // exclusively
+  uint64_t version = board._version;
+  if (_version.load(std::memory_order_relaxed) != version) {
+    return SHAREDGAMECLAIM_STALE;
+  }
+  if (!_version.compare_exchange_strong(version, version + 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+    return SHAREDGAMECLAIM_STALE;
+  }
+  // readers that see any of the new board words will also see the odd version
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // we won: the snapshot is the current board, and nobody else can change the
+  // game until we publish the next version
+  assert(_card_manager.get_state()._main_deck_size == board._main_deck_size);
+  for (unsigned char i = 0; i < 3; ++i) {
+    _card_manager.click_card(positions[i]);
+  }
+  publish();
+  _version.store(version + 2, std::memory_order_release);
+  return SHAREDGAMECLAIM_WON;
+}
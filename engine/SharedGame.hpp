@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file SharedGame.hpp
+ *
+ * @brief Single game shared by multiple players that claim sets concurrently.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_SHAREDGAME_HPP
+#define OPENSET_SHAREDGAME_HPP
+
+#include "CardManager.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Possible outcomes of a claim.
+ */
+enum SharedGameClaimResult {
+  /*! @brief The claim succeeded: the set was taken by this player. */
+  SHAREDGAMECLAIM_WON = 0,
+  /*! @brief The board changed since the snapshot was taken (usually because
+   *  another player claimed a set first). */
+  SHAREDGAMECLAIM_STALE,
+  /*! @brief The three positions do not make up a set on the snapshot. */
+  SHAREDGAMECLAIM_INVALID,
+  /*! @brief Counter. Should always be the last element! */
+  SHAREDGAMECLAIM_COUNTER
+};
+
+/**
+ * @brief Snapshot of the main deck of a SharedGame.
+ */
+struct SharedBoard {
+  /*! @brief Version of the board the snapshot was taken from. */
+  uint64_t _version;
+
+  /*! @brief Indices of the cards on the main deck. */
+  unsigned char _main_deck[GameState::MAX_BOARD_SIZE];
+
+  /*! @brief Number of cards on the main deck. */
+  unsigned char _main_deck_size;
+
+  /*! @brief Number of cards that were dealt from the card stack. */
+  unsigned char _next_card;
+
+  /*! @brief Number of sets on the main deck (0 if the game is finished). */
+  unsigned char _set_count;
+};
+
+/**
+ * @brief Single game shared by multiple players that claim sets concurrently.
+ *
+ * Players do not click cards one by one, but claim a whole set at once, using
+ * the positions of the three cards on a snapshot of the board (see read()).
+ * Exactly one claim per board version succeeds.
+ *
+ * The board is published as a version word followed by three words that
+ * contain the main deck, all in a single cache line. The version is even when
+ * the board is stable. A claim first checks the set on the snapshot of the
+ * player, which does not touch any shared memory, and then tries to swap the
+ * version of the snapshot for the next (odd) version. Only the player that
+ * wins this compare-and-swap updates the game; all other players see a
+ * different version and are rejected immediately, without waiting. When the
+ * winner is done, it publishes the new board and the next even version.
+ *
+ * Readers never block writers: read() simply retries if the version changed
+ * while the board was copied (a sequence lock). No mutex is used anywhere.
+ */
+class SharedGame {
+private:
+  /*! @brief Number of words used to publish the main deck. */
+  static const unsigned char NUMBER_OF_BOARD_WORDS = 3;
+
+  /*! @brief Version of the board: incremented by 2 for every set that is
+   *  taken. Odd while the winner of a claim updates the game. */
+  alignas(64) std::atomic<uint64_t> _version;
+
+  /*! @brief Published main deck: 18 card indices, followed by the size of the
+   *  main deck, the next card and the number of sets. */
+  std::atomic<uint64_t> _board[NUMBER_OF_BOARD_WORDS];
+
+  /*! @brief Game. Only accessed by the winner of a claim (or the
+   *  constructor). */
+  alignas(64) CardManager _card_manager;
+
+  void publish();
+
+public:
+  SharedGame(uint64_t seed);
+
+  SharedBoard read() const;
+
+  SharedGameClaimResult claim(const SharedBoard &board,
+                              const unsigned char *positions);
+
+  /**
+   * @brief Get the current version of the board.
+   *
+   * @return Version of the board (even if no claim is being processed).
+   */
+  inline uint64_t get_version() const {
+    return _version.load(std::memory_order_acquire);
+  }
+};
+
+static_assert(sizeof(SharedBoard::_main_deck) + 3 <= 3 * sizeof(uint64_t),
+              "The main deck does not fit in the published board words!");
+
+#endif // OPENSET_SHAREDGAME_HPP
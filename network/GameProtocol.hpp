@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file GameProtocol.hpp
+ *
+ * @brief Binary protocol spoken between the game server and its clients.
+ *
+ * All messages have a fixed size, so that framing is trivial: a client sends
+ * GameRequests and receives exactly one GameReply per request, in order.
+ * Requests can be pipelined. Multi-byte fields are in host byte order, since
+ * the server only listens on Unix-domain sockets and the loopback interface.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMEPROTOCOL_HPP
+#define OPENSET_GAMEPROTOCOL_HPP
+
+#include "../engine/GameState.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Types of requests.
+ */
+enum GameRequestType {
+  /*! @brief Get the current board of a game. */
+  GAMEREQUEST_BOARD = 0,
+  /*! @brief Claim a set (argument: version of the board the positions refer
+   *  to). */
+  GAMEREQUEST_CLAIM,
+  /*! @brief Deal a new game at the table (argument: seed). */
+  GAMEREQUEST_DEAL,
+  /*! @brief Counter. Should always be the last element! */
+  GAMEREQUEST_COUNTER
+};
+
+/**
+ * @brief Possible results of a request.
+ */
+enum GameReplyResult {
+  /*! @brief The board or deal request succeeded. */
+  GAMEREPLY_OK = 0,
+  /*! @brief The claim succeeded: the set was taken. */
+  GAMEREPLY_WON,
+  /*! @brief The claim refers to an older version of the board. */
+  GAMEREPLY_STALE,
+  /*! @brief The claimed cards do not make up a set. */
+  GAMEREPLY_INVALID,
+  /*! @brief The request is malformed or refers to a game that does not
+   *  exist. */
+  GAMEREPLY_ERROR,
+  /*! @brief Counter. Should always be the last element! */
+  GAMEREPLY_COUNTER
+};
+
+/**
+ * @brief Request sent by a client.
+ */
+struct GameRequest {
+  /*! @brief Type of the request (see GameRequestType). */
+  uint8_t _type;
+
+  /*! @brief Positions of the claimed cards on the main deck (claim only). */
+  uint8_t _positions[3];
+
+  /*! @brief Index of the game. */
+  uint32_t _game;
+
+  /*! @brief Argument of the request: board version (claim) or seed
+   *  (deal). */
+  uint64_t _argument;
+};
+
+/**
+ * @brief Reply sent by the server: the result of the request and the board
+ * of the game after the request was handled.
+ */
+struct GameReply {
+  /*! @brief Type of the request this is a reply to (see GameRequestType). */
+  uint8_t _type;
+
+  /*! @brief Result of the request (see GameReplyResult). */
+  uint8_t _result;
+
+  /*! @brief Number of cards on the main deck. */
+  uint8_t _main_deck_size;
+
+  /*! @brief Number of cards that were dealt from the card stack. */
+  uint8_t _next_card;
+
+  /*! @brief Index of the game. */
+  uint32_t _game;
+
+  /*! @brief Version of the board: changes every time the board changes. */
+  uint32_t _version;
+
+  /*! @brief Indices of the cards on the main deck. */
+  uint8_t _main_deck[GameState::MAX_BOARD_SIZE];
+
+  /*! @brief Padding (always zero). */
+  uint8_t _padding[2];
+};
+
+static_assert(sizeof(GameRequest) == 16, "Unexpected GameRequest size!");
+static_assert(sizeof(GameReply) == 32, "Unexpected GameReply size!");
+
+#endif // OPENSET_GAMEPROTOCOL_HPP
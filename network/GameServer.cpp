@@ -0,0 +1,378 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file GameServer.cpp
+ *
+ * @brief GameServer implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "GameServer.hpp"
+#include "Socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/*! @brief Maximum number of events handled per call to epoll_wait(). */
+#define GAMESERVER_MAX_EVENTS 256
+
+/*! @brief Size of the buffer used to read from a connection. */
+#define GAMESERVER_READ_BUFFER_SIZE 4096
+
+/**
+ * @brief Constructor.
+ *
+ * Game i is dealt using seed SEED + i.
+ *
+ * @param address Address to listen on (see Socket).
+ * @param number_of_games Number of games to host.
+ * @param seed Seed of the first game.
+ */
+GameServer::GameServer(const std::string &address, uint32_t number_of_games,
+                       uint64_t seed)
+    : _address(address), _listen_socket(Socket::listen(address)),
+      _epoll(epoll_create1(0)), _stop_event(eventfd(0, EFD_NONBLOCK)),
+      _games(number_of_games), _versions(number_of_games, 0),
+      _card_manager(seed), _number_of_requests{}, _number_of_replies{},
+      _maximum_output_size(0) {
+  for (uint32_t i = 0; i < number_of_games; ++i) {
+    _games[i] = CardManager(seed + i).snapshot();
+  }
+
+  if (_listen_socket >= 0 && _epoll >= 0 && _stop_event >= 0) {
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = _listen_socket;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _listen_socket, &event);
+    event.data.fd = _stop_event;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _stop_event, &event);
+  }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Closes all connections, and removes the socket file if the server listens
+ * on a Unix-domain socket.
+ */
+GameServer::~GameServer() {
+  for (auto it = _connections.begin(); it != _connections.end(); ++it) {
+    close(it->first);
+  }
+  if (_listen_socket >= 0) {
+    close(_listen_socket);
+    Socket::remove(_address);
+  }
+  if (_epoll >= 0) {
+    close(_epoll);
+  }
+  if (_stop_event >= 0) {
+    close(_stop_event);
+  }
+}
+
+/**
+ * @brief Check if the server was set up successfully.
+ *
+ * @return True if the server is listening on its address.
+ */
+bool GameServer::is_listening() const {
+  return _listen_socket >= 0 && _epoll >= 0 && _stop_event >= 0;
+}
+
+/**
+ * @brief Handle events until stop() is called.
+ */
+void GameServer::run() {
+  epoll_event events[GAMESERVER_MAX_EVENTS];
+  while (true) {
+    const int number_of_events =
+        epoll_wait(_epoll, events, GAMESERVER_MAX_EVENTS, -1);
+    if (number_of_events < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    for (int i = 0; i < number_of_events; ++i) {
+      const int file_descriptor = events[i].data.fd;
+      if (file_descriptor == _stop_event) {
+        uint64_t value;
+        if (read(_stop_event, &value, sizeof(value)) < 0) {
+          // the event was already consumed: we stop anyway
+        }
+        return;
+      } else if (file_descriptor == _listen_socket) {
+        accept_connections();
+      } else {
+        if (events[i].events & EPOLLIN) {
+          read_requests(file_descriptor);
+        }
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+          // handle the requests that are still buffered before closing
+          while (_connections.count(file_descriptor) > 0 &&
+                 read_requests(file_descriptor)) {
+          }
+          if (_connections.count(file_descriptor) > 0) {
+            close_connection(file_descriptor);
+          }
+          continue;
+        }
+        if ((events[i].events & EPOLLOUT) &&
+            _connections.count(file_descriptor) > 0) {
+          write_replies(file_descriptor);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Make run() return.
+ *
+ * This function can be called from any thread, and from a signal handler.
+ */
+void GameServer::stop() {
+  const uint64_t value = 1;
+  if (write(_stop_event, &value, sizeof(value)) < 0) {
+    // the counter is already non-zero: the loop will stop
+  }
+}
+
+/**
+ * @brief Get the number of requests of the given type that was handled.
+ *
+ * @param type GameRequestType.
+ * @return Number of requests.
+ */
+unsigned long GameServer::get_number_of_requests(GameRequestType type) const {
+  return _number_of_requests[type];
+}
+
+/**
+ * @brief Get the number of replies with the given result that was sent.
+ *
+ * @param result GameReplyResult.
+ * @return Number of replies.
+ */
+unsigned long GameServer::get_number_of_replies(GameReplyResult result) const {
+  return _number_of_replies[result];
+}
+
+/**
+ * @brief Get the largest number of reply bytes that was queued for a single
+ * connection.
+ *
+ * @return Maximum size of an output queue (in bytes).
+ */
+size_t GameServer::get_maximum_output_size() const {
+  return _maximum_output_size;
+}
+
+/**
+ * @brief Accept all pending connections.
+ */
+void GameServer::accept_connections() {
+  int connection = Socket::accept(_listen_socket);
+  while (connection >= 0) {
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = connection;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, connection, &event) < 0) {
+      close(connection);
+    } else {
+      _connections[connection]._events = EPOLLIN;
+    }
+    connection = Socket::accept(_listen_socket);
+  }
+}
+
+/**
+ * @brief Close the given connection.
+ *
+ * @param connection Connection.
+ */
+void GameServer::close_connection(int connection) {
+  epoll_ctl(_epoll, EPOLL_CTL_DEL, connection, NULL);
+  close(connection);
+  _connections.erase(connection);
+}
+
+/**
+ * @brief Read and handle all requests that are available on the given
+ * connection.
+ *
+ * Replies to all complete requests are queued and sent in one go.
+ *
+ * @param connection Connection.
+ * @return True if data was read and the connection is still open.
+ */
+bool GameServer::read_requests(int connection) {
+  Connection &state = _connections[connection];
+  unsigned char buffer[GAMESERVER_READ_BUFFER_SIZE];
+  const ssize_t size = read(connection, buffer, sizeof(buffer));
+  if (size <= 0) {
+    if (size == 0 || (errno != EAGAIN && errno != EINTR)) {
+      close_connection(connection);
+    }
+    return false;
+  }
+  state._input.insert(state._input.end(), buffer, buffer + size);
+
+  const size_t number_of_requests = state._input.size() / sizeof(GameRequest);
+  const size_t output_size = state._output.size();
+  state._output.resize(output_size + number_of_requests * sizeof(GameReply));
+  for (size_t i = 0; i < number_of_requests; ++i) {
+    GameRequest request;
+    std::memcpy(&request, state._input.data() + i * sizeof(GameRequest),
+                sizeof(GameRequest));
+    GameReply reply;
+    handle_request(request, reply);
+    std::memcpy(state._output.data() + output_size + i * sizeof(GameReply),
+                &reply, sizeof(GameReply));
+  }
+  state._input.erase(state._input.begin(),
+                     state._input.begin() +
+                         number_of_requests * sizeof(GameRequest));
+  if (state._output.size() > _maximum_output_size) {
+    _maximum_output_size = state._output.size();
+  }
+
+  write_replies(connection);
+  return _connections.count(connection) > 0;
+}
+
+/**
+ * @brief Send as many queued replies as possible on the given connection.
+ *
+ * If not all replies could be sent, we wait until the connection becomes
+ * writable again.
+ *
+ * @param connection Connection.
+ */
+void GameServer::write_replies(int connection) {
+  Connection &state = _connections[connection];
+  size_t offset = 0;
+  while (offset < state._output.size()) {
+    const ssize_t size = write(connection, state._output.data() + offset,
+                               state._output.size() - offset);
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN) {
+        close_connection(connection);
+        return;
+      }
+      break;
+    }
+    offset += size;
+  }
+  state._output.erase(state._output.begin(), state._output.begin() + offset);
+  update_events(connection);
+}
+
+/**
+ * @brief Register the given connection for the events it needs.
+ *
+ * We wait for the connection to become writable as long as replies are
+ * queued, and only read new requests while the queue is below
+ * MAX_OUTPUT_SIZE, so that a client that does not read its replies cannot
+ * make the queue grow without limit. Errors and hangups are always reported.
+ *
+ * @param connection Connection.
+ */
+void GameServer::update_events(int connection) {
+  Connection &state = _connections[connection];
+  uint32_t events = 0;
+  if (state._output.size() < MAX_OUTPUT_SIZE) {
+    events |= EPOLLIN;
+  }
+  if (!state._output.empty()) {
+    events |= EPOLLOUT;
+  }
+  if (events != state._events) {
+    epoll_event event;
+    event.events = events;
+    event.data.fd = connection;
+    epoll_ctl(_epoll, EPOLL_CTL_MOD, connection, &event);
+    state._events = events;
+  }
+}
+
+/**
+ * @brief Handle a single request.
+ *
+ * @param request GameRequest.
+ * @param reply GameReply to fill in.
+ */
+void GameServer::handle_request(const GameRequest &request,
+                                GameReply &reply) {
+  std::memset(&reply, 0, sizeof(reply));
+  reply._type = request._type;
+  reply._game = request._game;
+  if (request._game >= _games.size() ||
+      request._type >= GAMEREQUEST_COUNTER) {
+    reply._result = GAMEREPLY_ERROR;
+    ++_number_of_replies[GAMEREPLY_ERROR];
+    return;
+  }
+  ++_number_of_requests[request._type];
+
+  GameState &game = _games[request._game];
+  uint32_t &version = _versions[request._game];
+  reply._result = GAMEREPLY_OK;
+  if (request._type == GAMEREQUEST_CLAIM) {
+    const unsigned char *positions = request._positions;
+    if (request._argument != version) {
+      reply._result = GAMEREPLY_STALE;
+    } else if (positions[0] >= game._main_deck_size ||
+               positions[1] >= game._main_deck_size ||
+               positions[2] >= game._main_deck_size ||
+               positions[0] == positions[1] || positions[0] == positions[2] ||
+               positions[1] == positions[2] ||
+               !CardIndex::is_set(game._main_deck[positions[0]],
+                                  game._main_deck[positions[1]],
+                                  game._main_deck[positions[2]])) {
+      reply._result = GAMEREPLY_INVALID;
+    } else {
+      // the set index of the scratch CardManager is invalid after restoring
+      // and is not rebuilt to take a single set
+      _card_manager.restore(game);
+      _card_manager.click_card(positions[0]);
+      _card_manager.click_card(positions[1]);
+      _card_manager.click_card(positions[2]);
+      game = _card_manager.snapshot();
+      ++version;
+      reply._result = GAMEREPLY_WON;
+    }
+  } else if (request._type == GAMEREQUEST_DEAL) {
+    game = CardManager(request._argument).snapshot();
+    ++version;
+  }
+  ++_number_of_replies[reply._result];
+
+  reply._main_deck_size = game._main_deck_size;
+  reply._next_card = game._next_card;
+  reply._version = version;
+  std::memcpy(reply._main_deck, game._main_deck, game._main_deck_size);
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file GameServer.hpp
+ *
+ * @brief Event-driven server that hosts a large number of games.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_GAMESERVER_HPP
+#define OPENSET_GAMESERVER_HPP
+
+#include "../engine/CardManager.hpp"
+#include "GameProtocol.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Event-driven server that hosts a large number of games.
+ *
+ * A single thread multiplexes all client connections using epoll. Every game
+ * is stored as a bare GameState (and a board version), so that a server can
+ * host many thousands of games: a request restores the game into a single
+ * scratch CardManager, handles the request and takes a snapshot again.
+ *
+ * Any number of clients can play the same game. Claims refer to the version of
+ * the board the client saw, so that exactly one of several clients claiming a
+ * set on the same board wins, and all others get a stale reply.
+ *
+ * Clients can pipeline requests. A client that keeps sending requests without
+ * reading the replies is throttled: once more than MAX_OUTPUT_SIZE bytes of
+ * replies are queued for a connection, the server stops reading from it until
+ * the queue drains.
+ */
+class GameServer {
+public:
+  /*! @brief Number of queued reply bytes above which we stop reading
+   *  requests from a connection, until the client reads its replies. */
+  static const size_t MAX_OUTPUT_SIZE = 65536;
+
+private:
+  /**
+   * @brief Connection with a single client.
+   */
+  struct Connection {
+    /*! @brief Bytes received that do not make up a complete request yet. */
+    std::vector<unsigned char> _input;
+
+    /*! @brief Bytes that still need to be sent. */
+    std::vector<unsigned char> _output;
+
+    /*! @brief Events the connection is registered for in the epoll
+     *  instance. */
+    uint32_t _events;
+  };
+
+  /*! @brief Address the server listens on. */
+  std::string _address;
+
+  /*! @brief Socket the server listens on. */
+  int _listen_socket;
+
+  /*! @brief Epoll instance. */
+  int _epoll;
+
+  /*! @brief Event file descriptor used to stop the event loop. */
+  int _stop_event;
+
+  /*! @brief Open connections, indexed on their file descriptor. */
+  std::unordered_map<int, Connection> _connections;
+
+  /*! @brief States of all games. */
+  std::vector<GameState> _games;
+
+  /*! @brief Board versions of all games. */
+  std::vector<uint32_t> _versions;
+
+  /*! @brief CardManager used to handle requests. */
+  CardManager _card_manager;
+
+  /*! @brief Number of requests that was handled, per request type. */
+  unsigned long _number_of_requests[GAMEREQUEST_COUNTER];
+
+  /*! @brief Number of replies that was sent, per result. */
+  unsigned long _number_of_replies[GAMEREPLY_COUNTER];
+
+  /*! @brief Largest number of bytes that was queued for a connection. */
+  size_t _maximum_output_size;
+
+  void accept_connections();
+  void close_connection(int connection);
+  bool read_requests(int connection);
+  void write_replies(int connection);
+  void update_events(int connection);
+
+  void handle_request(const GameRequest &request, GameReply &reply);
+
+public:
+  GameServer(const std::string &address, uint32_t number_of_games,
+             uint64_t seed);
+  ~GameServer();
+
+  bool is_listening() const;
+
+  void run();
+  void stop();
+
+  unsigned long get_number_of_requests(GameRequestType type) const;
+  unsigned long get_number_of_replies(GameReplyResult result) const;
+  size_t get_maximum_output_size() const;
+};
+
+#endif // OPENSET_GAMESERVER_HPP
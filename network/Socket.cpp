@@ -0,0 +1,263 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file Socket.cpp
+ *
+ * @brief Socket implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "Socket.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Check if the given address is the path of a Unix-domain socket.
+ *
+ * @param address Address.
+ * @return True if the address contains a '/'.
+ */
+static bool is_unix_address(const std::string &address) {
+  return address.find('/') != std::string::npos;
+}
+
+/**
+ * @brief Fill in the Unix-domain socket address for the given path.
+ *
+ * @param path Path of the socket.
+ * @param unix_address Socket address to fill in.
+ * @return True on success, false if the path is too long.
+ */
+static bool get_unix_address(const std::string &path,
+                             sockaddr_un &unix_address) {
+  std::memset(&unix_address, 0, sizeof(unix_address));
+  if (path.size() >= sizeof(unix_address.sun_path)) {
+    return false;
+  }
+  unix_address.sun_family = AF_UNIX;
+  std::memcpy(unix_address.sun_path, path.c_str(), path.size());
+  return true;
+}
+
+/**
+ * @brief Fill in the loopback socket address for the given port.
+ *
+ * @param port Port number: a decimal number in the range [1, 65535].
+ * @param inet_address Socket address to fill in.
+ * @return True on success, false if the port is not a valid port number.
+ */
+static bool get_inet_address(const std::string &port,
+                             sockaddr_in &inet_address) {
+  // strtoul() silently turns anything that is not a number into port 0,
+  // which would make the kernel choose a random port
+  if (port.empty() || port.size() > 5 ||
+      port.find_first_not_of("0123456789") != std::string::npos) {
+    errno = EINVAL;
+    return false;
+  }
+  const unsigned long port_number = strtoul(port.c_str(), NULL, 10);
+  if (port_number == 0 || port_number > 65535) {
+    errno = EINVAL;
+    return false;
+  }
+  std::memset(&inet_address, 0, sizeof(inet_address));
+  inet_address.sin_family = AF_INET;
+  inet_address.sin_port = htons(port_number);
+  inet_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  return true;
+}
+
+/**
+ * @brief Remove the file at the given path if it is a socket.
+ *
+ * @param path Path of a Unix-domain socket.
+ * @return True if there is no file at the given path (anymore), false if the
+ * path exists but is not a socket (errno is set to EEXIST), or could not be
+ * removed.
+ */
+static bool remove_socket_file(const std::string &path) {
+  struct stat file_status;
+  if (lstat(path.c_str(), &file_status) < 0) {
+    return errno == ENOENT;
+  }
+  if (!S_ISSOCK(file_status.st_mode)) {
+    errno = EEXIST;
+    return false;
+  }
+  return unlink(path.c_str()) == 0;
+}
+
+/**
+ * @brief Open a non-blocking socket that listens on the given address.
+ *
+ * An existing Unix-domain socket file with the same path is removed first.
+ * Any other file at that path is left alone, and the call fails.
+ *
+ * @param address Address to listen on.
+ * @return File descriptor of the listening socket, or -1 on failure.
+ */
+int Socket::listen(const std::string &address) {
+  int listen_socket;
+  if (is_unix_address(address)) {
+    sockaddr_un unix_address;
+    if (!get_unix_address(address, unix_address)) {
+      return -1;
+    }
+    if (!remove_socket_file(address)) {
+      return -1;
+    }
+    listen_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_socket < 0) {
+      return -1;
+    }
+    if (bind(listen_socket, reinterpret_cast<sockaddr *>(&unix_address),
+             sizeof(unix_address)) < 0) {
+      close(listen_socket);
+      return -1;
+    }
+  } else {
+    sockaddr_in inet_address;
+    if (!get_inet_address(address, inet_address)) {
+      return -1;
+    }
+    listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_socket < 0) {
+      return -1;
+    }
+    const int reuse = 1;
+    setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(listen_socket, reinterpret_cast<sockaddr *>(&inet_address),
+             sizeof(inet_address)) < 0) {
+      close(listen_socket);
+      return -1;
+    }
+  }
+  if (::listen(listen_socket, SOMAXCONN) < 0 ||
+      !set_non_blocking(listen_socket)) {
+    close(listen_socket);
+    return -1;
+  }
+  return listen_socket;
+}
+
+/**
+ * @brief Remove the socket file of a Unix-domain socket address that is no
+ * longer listened on.
+ *
+ * Nothing happens for TCP addresses, or if the path is not a socket.
+ *
+ * @param address Address that was passed to listen().
+ */
+void Socket::remove(const std::string &address) {
+  if (is_unix_address(address)) {
+    remove_socket_file(address);
+  }
+}
+
+/**
+ * @brief Open a blocking connection to the given address.
+ *
+ * Nagle's algorithm is disabled for TCP connections, since all messages are
+ * small and latency sensitive.
+ *
+ * @param address Address to connect to.
+ * @return File descriptor of the connected socket, or -1 on failure.
+ */
+int Socket::connect(const std::string &address) {
+  int connection;
+  if (is_unix_address(address)) {
+    sockaddr_un unix_address;
+    if (!get_unix_address(address, unix_address)) {
+      return -1;
+    }
+    connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0) {
+      return -1;
+    }
+    if (::connect(connection, reinterpret_cast<sockaddr *>(&unix_address),
+                  sizeof(unix_address)) < 0) {
+      close(connection);
+      return -1;
+    }
+  } else {
+    sockaddr_in inet_address;
+    if (!get_inet_address(address, inet_address)) {
+      return -1;
+    }
+    connection = socket(AF_INET, SOCK_STREAM, 0);
+    if (connection < 0) {
+      return -1;
+    }
+    if (::connect(connection, reinterpret_cast<sockaddr *>(&inet_address),
+                  sizeof(inet_address)) < 0) {
+      close(connection);
+      return -1;
+    }
+    const int no_delay = 1;
+    setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+               sizeof(no_delay));
+  }
+  return connection;
+}
+
+/**
+ * @brief Accept a new connection on the given listening socket.
+ *
+ * The new connection is non-blocking and has Nagle's algorithm disabled.
+ *
+ * @param listen_socket Listening socket.
+ * @return File descriptor of the new connection, or -1 if there is no
+ * pending connection (or on failure).
+ */
+int Socket::accept(int listen_socket) {
+  const int connection = ::accept(listen_socket, NULL, NULL);
+  if (connection < 0) {
+    return -1;
+  }
+  if (!set_non_blocking(connection)) {
+    close(connection);
+    return -1;
+  }
+  // this fails harmlessly for Unix-domain sockets
+  const int no_delay = 1;
+  setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+             sizeof(no_delay));
+  return connection;
+}
+
+/**
+ * @brief Make the given socket non-blocking.
+ *
+ * @param socket Socket.
+ * @return True on success.
+ */
+bool Socket::set_non_blocking(int socket) {
+  const int flags = fcntl(socket, F_GETFL, 0);
+  return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
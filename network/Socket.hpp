@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file Socket.hpp
+ *
+ * @brief Helper functions to open local stream sockets.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_SOCKET_HPP
+#define OPENSET_SOCKET_HPP
+
+#include <string>
+
+/**
+ * @brief Helper functions to open local stream sockets.
+ *
+ * Addresses are either the path of a Unix-domain socket (any address that
+ * contains a '/', e.g. ./openset.sock), or a TCP port number on the loopback
+ * interface. Addresses that are neither are rejected. All functions return a
+ * file descriptor, or -1 on failure (errno is set).
+ */
+class Socket {
+public:
+  static int listen(const std::string &address);
+  static void remove(const std::string &address);
+  static int connect(const std::string &address);
+  static int accept(int listen_socket);
+
+  static bool set_non_blocking(int socket);
+};
+
+#endif // OPENSET_SOCKET_HPP
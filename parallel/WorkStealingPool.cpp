@@ -0,0 +1,388 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file WorkStealingPool.cpp
+ *
+ * @brief WorkStealingPool implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "WorkStealingPool.hpp"
+#include "../engine/RandomGenerator.hpp"
+
+#include <algorithm>
+
+/*! @brief Pool the current thread is a worker of (NULL for other threads). */
+static thread_local WorkStealingPool *current_pool = NULL;
+
+/*! @brief Index of the current thread in the pool it is a worker of. */
+static thread_local unsigned int current_worker = 0;
+
+/**
+ * @brief Constructor.
+ *
+ * Starts the worker threads.
+ *
+ * @param number_of_workers Number of worker threads (0 to use one thread per
+ * core).
+ * @param seed Seed for the random generators used to choose victims.
+ */
+WorkStealingPool::WorkStealingPool(unsigned int number_of_workers,
+                                   uint64_t seed)
+    : _seed(seed), _number_of_queued_tasks(0), _number_of_unfinished_tasks(0),
+      _next_worker(0), _stop(false) {
+  if (number_of_workers == 0) {
+    number_of_workers = std::thread::hardware_concurrency();
+  }
+  if (number_of_workers == 0) {
+    number_of_workers = 1;
+  }
+  for (unsigned int i = 0; i < number_of_workers; ++i) {
+    _workers.push_back(std::unique_ptr<Worker>(new Worker()));
+  }
+  reset_statistics();
+  for (unsigned int i = 0; i < number_of_workers; ++i) {
+    _threads.push_back(std::thread(&WorkStealingPool::run, this, i));
+  }
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Waits until all tasks are finished and stops the worker threads.
+ */
+WorkStealingPool::~WorkStealingPool() {
+  wait();
+  {
+    std::lock_guard<std::mutex> lock(_sleep_mutex);
+    _stop = true;
+  }
+  _work_available.notify_all();
+  for (unsigned int i = 0; i < _threads.size(); ++i) {
+    _threads[i].join();
+  }
+}
+
+/**
+ * @brief Get the number of worker threads.
+ *
+ * @return Number of workers.
+ */
+unsigned int WorkStealingPool::get_number_of_workers() const {
+  return _workers.size();
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ *
+ * @param worker Index of the worker.
+ */
+void WorkStealingPool::run(unsigned int worker) {
+  current_pool = this;
+  current_worker = worker;
+  RandomGenerator random_generator(_seed + worker);
+  const unsigned int number_of_victims = _workers.size() - 1;
+  Worker &state = *_workers[worker];
+  Task task;
+  while (true) {
+    bool found = pop(worker, task);
+    for (unsigned int attempt = 0; !found && attempt < 2 * number_of_victims;
+         ++attempt) {
+      uint32_t victim = random_generator.get_random_integer(number_of_victims);
+      if (victim >= worker) {
+        ++victim;
+      }
+      found = steal(worker, victim, task);
+    }
+
+    if (found) {
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      task(worker);
+      const std::chrono::steady_clock::time_point stop =
+          std::chrono::steady_clock::now();
+      // release everything the task holds on to before we report it finished
+      task = nullptr;
+      state._busy_time.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+              .count(),
+          std::memory_order_relaxed);
+      state._number_of_tasks.fetch_add(1, std::memory_order_relaxed);
+      if (_number_of_unfinished_tasks.fetch_sub(1) == 1) {
+        {
+          std::lock_guard<std::mutex> lock(_sleep_mutex);
+        }
+        _all_done.notify_all();
+      }
+      continue;
+    }
+
+    // no task anywhere (that we could find): sleep until new tasks are
+    // queued. If there are queued tasks we could not steal, we try again
+    std::unique_lock<std::mutex> lock(_sleep_mutex);
+    _work_available.wait(
+        lock, [this] { return _number_of_queued_tasks.load() > 0 || _stop; });
+    if (_stop && _number_of_queued_tasks.load() == 0) {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Take the newest task from the deque of the given worker.
+ *
+ * @param worker Index of the worker.
+ * @param task Variable to store the task in.
+ * @return True on success, false if the deque is empty.
+ */
+bool WorkStealingPool::pop(unsigned int worker, Task &task) {
+  Worker &state = *_workers[worker];
+  std::lock_guard<std::mutex> lock(state._mutex);
+  if (state._tasks.empty()) {
+    return false;
+  }
+  task = std::move(state._tasks.back());
+  state._tasks.pop_back();
+  _number_of_queued_tasks.fetch_sub(1);
+  return true;
+}
+
+/**
+ * @brief Steal the oldest task from the deque of the given victim.
+ *
+ * @param worker Index of the worker that steals.
+ * @param victim Index of the worker that is stolen from.
+ * @param task Variable to store the task in.
+ * @return True on success, false if the deque of the victim is empty.
+ */
+bool WorkStealingPool::steal(unsigned int worker, uint32_t victim,
+                             Task &task) {
+  Worker &state = *_workers[victim];
+  {
+    std::lock_guard<std::mutex> lock(state._mutex);
+    if (!state._tasks.empty()) {
+      task = std::move(state._tasks.front());
+      state._tasks.pop_front();
+      _number_of_queued_tasks.fetch_sub(1);
+      _workers[worker]->_number_of_steals.fetch_add(
+          1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  _workers[worker]->_number_of_failed_steals.fetch_add(
+      1, std::memory_order_relaxed);
+  return false;
+}
+
+/**
+ * @brief Add a task to the back of the deque of the given worker.
+ *
+ * The task should already be counted as unfinished.
+ *
+ * @param worker Index of the worker.
+ * @param task Task.
+ */
+void WorkStealingPool::push(unsigned int worker, Task &&task) {
+  // the task is counted before it can be taken, so that the counter never
+  // drops below zero
+  _number_of_queued_tasks.fetch_add(1);
+  Worker &state = *_workers[worker];
+  std::lock_guard<std::mutex> lock(state._mutex);
+  state._tasks.push_back(std::move(task));
+}
+
+/**
+ * @brief Wake up sleeping workers.
+ *
+ * @param all Wake up all workers (or only one)?
+ */
+void WorkStealingPool::wake_up(bool all) {
+  // taking the mutex makes sure a worker that is about to sleep either sees
+  // the new tasks or is already waiting for the notification
+  {
+    std::lock_guard<std::mutex> lock(_sleep_mutex);
+  }
+  if (all) {
+    _work_available.notify_all();
+  } else {
+    _work_available.notify_one();
+  }
+}
+
+/**
+ * @brief Submit a task.
+ *
+ * Tasks submitted by a running task are added to the deque of the worker that
+ * runs it. Other tasks are spread over the workers in turn.
+ *
+ * @param task Task.
+ */
+void WorkStealingPool::submit(Task task) {
+  _number_of_unfinished_tasks.fetch_add(1);
+  unsigned int worker;
+  if (current_pool == this) {
+    worker = current_worker;
+  } else {
+    worker = _next_worker.fetch_add(1) % _workers.size();
+  }
+  push(worker, std::move(task));
+  wake_up(false);
+}
+
+/**
+ * @brief Wait until all submitted tasks (and all tasks they submitted) are
+ * finished.
+ *
+ * Should not be called from within a task.
+ */
+void WorkStealingPool::wait() {
+  std::unique_lock<std::mutex> lock(_sleep_mutex);
+  _all_done.wait(lock,
+                 [this] { return _number_of_unfinished_tasks.load() == 0; });
+  _statistics_end = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Execute a batch of tasks and wait until they are finished.
+ *
+ * The batch is split in chunks of contiguous task indices, about
+ * CHUNKS_PER_WORKER per worker, and every chunk is queued as a single task
+ * that executes its indices in order. This keeps the memory used by a batch
+ * independent of its size. The chunks are initially divided in equal
+ * contiguous parts, one per worker. Workers that finish their part early
+ * steal the remaining chunks of the others, so that all workers stay busy
+ * until the batch drains. Should not be called from within a task.
+ *
+ * @param number_of_tasks Number of tasks in the batch.
+ * @param task Function that executes the task with the given index.
+ */
+void WorkStealingPool::run_batch(unsigned long number_of_tasks,
+                                 BatchTask task) {
+  if (number_of_tasks == 0) {
+    return;
+  }
+  const unsigned int number_of_workers = _workers.size();
+  const unsigned long chunk_size = std::max<unsigned long>(
+      1, number_of_tasks / (number_of_workers * CHUNKS_PER_WORKER));
+  const unsigned long number_of_chunks =
+      (number_of_tasks + chunk_size - 1) / chunk_size;
+  _number_of_unfinished_tasks.fetch_add(number_of_chunks);
+  _number_of_queued_tasks.fetch_add(number_of_chunks);
+  for (unsigned int worker = 0; worker < number_of_workers; ++worker) {
+    const unsigned long first_chunk =
+        worker * number_of_chunks / number_of_workers;
+    const unsigned long last_chunk =
+        (worker + 1) * number_of_chunks / number_of_workers;
+    Worker &state = *_workers[worker];
+    std::lock_guard<std::mutex> lock(state._mutex);
+    // the owner takes tasks from the back: push in reverse order, so that
+    // every part is executed in order
+    for (unsigned long i = last_chunk; i > first_chunk; --i) {
+      const unsigned long first = (i - 1) * chunk_size;
+      const unsigned long last =
+          std::min(first + chunk_size, number_of_tasks);
+      state._tasks.push_back([&task, first, last](unsigned int worker) {
+        for (unsigned long index = first; index < last; ++index) {
+          task(index, worker);
+        }
+      });
+    }
+  }
+  wake_up(true);
+  wait();
+}
+
+/**
+ * @brief Reset all statistics.
+ *
+ * The utilization is measured from this call up to the last time wait()
+ * returned. Should not be called while tasks are running.
+ */
+void WorkStealingPool::reset_statistics() {
+  for (unsigned int i = 0; i < _workers.size(); ++i) {
+    _workers[i]->_number_of_tasks.store(0);
+    _workers[i]->_number_of_steals.store(0);
+    _workers[i]->_number_of_failed_steals.store(0);
+    _workers[i]->_busy_time.store(0);
+  }
+  _statistics_start = std::chrono::steady_clock::now();
+  _statistics_end = _statistics_start;
+}
+
+/**
+ * @brief Get the number of tasks that was executed by the given worker.
+ *
+ * @param worker Index of the worker.
+ * @return Number of executed tasks.
+ */
+unsigned long WorkStealingPool::get_number_of_tasks(unsigned int worker) const {
+  return _workers[worker]->_number_of_tasks.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of tasks that was stolen by the given worker.
+ *
+ * @param worker Index of the worker.
+ * @return Number of successful steals.
+ */
+unsigned long
+WorkStealingPool::get_number_of_steals(unsigned int worker) const {
+  return _workers[worker]->_number_of_steals.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of steal attempts of the given worker that found an
+ * empty deque.
+ *
+ * @param worker Index of the worker.
+ * @return Number of failed steals.
+ */
+unsigned long
+WorkStealingPool::get_number_of_failed_steals(unsigned int worker) const {
+  return _workers[worker]->_number_of_failed_steals.load(
+      std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the time the given worker spent executing tasks.
+ *
+ * @param worker Index of the worker.
+ * @return Busy time (in s).
+ */
+double WorkStealingPool::get_busy_time(unsigned int worker) const {
+  return 1.e-9 * _workers[worker]->_busy_time.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the fraction of time the given worker spent executing tasks.
+ *
+ * @param worker Index of the worker.
+ * @return Busy time divided by the time between the last reset of the
+ * statistics and the last time wait() returned (0 if wait() was not called
+ * since the reset).
+ */
+double WorkStealingPool::get_utilization(unsigned int worker) const {
+  const double time =
+      std::chrono::duration<double>(_statistics_end - _statistics_start)
+          .count();
+  if (time <= 0.) {
+    return 0.;
+  }
+  return get_busy_time(worker) / time;
+}
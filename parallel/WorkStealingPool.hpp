@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file WorkStealingPool.hpp
+ *
+ * @brief Thread pool with per-worker task deques and randomized stealing.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_WORKSTEALINGPOOL_HPP
+#define OPENSET_WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Thread pool with per-worker task deques and randomized stealing.
+ *
+ * Every worker thread owns a deque of tasks. A worker takes its own tasks from
+ * the back of its deque (newest first, which keeps related work on the same
+ * core), and when its deque is empty, it steals tasks from the front of the
+ * deque of randomly chosen other workers (oldest first). Tasks submitted by a
+ * running task end up in the deque of the worker that runs it; tasks
+ * submitted from outside the pool are spread over all deques. Workers only
+ * go to sleep when there are no queued tasks left anywhere.
+ *
+ * Every deque is protected by its own mutex, which is only contended when a
+ * thief and the owner access the same deque at the same time. Taking the
+ * mutex costs in the order of 100 ns per task, so tasks should do at least a
+ * few microseconds of work for this cost to be negligible. Finer grained work
+ * should be grouped into larger tasks; run_batch() does this automatically by
+ * queueing chunks of task indices.
+ *
+ * The pool keeps per-worker counters: the number of tasks that was executed,
+ * the number of successful and failed steal attempts, and the time spent
+ * executing tasks, from which the utilization of every worker is derived.
+ */
+class WorkStealingPool {
+public:
+  /*! @brief Task: takes the index of the worker that executes it as
+   *  argument. */
+  typedef std::function<void(unsigned int worker)> Task;
+
+  /*! @brief Task in a batch: takes the index of the task in the batch and the
+   *  index of the worker that executes it as arguments. */
+  typedef std::function<void(unsigned long task, unsigned int worker)>
+      BatchTask;
+
+  /*! @brief Number of chunks per worker a batch is split into by
+   *  run_batch(). */
+  static const unsigned int CHUNKS_PER_WORKER = 8;
+
+private:
+  /**
+   * @brief Deque and counters of a single worker.
+   */
+  struct Worker {
+    /*! @brief Mutex that protects the deque. */
+    std::mutex _mutex;
+
+    /*! @brief Queued tasks. */
+    std::deque<Task> _tasks;
+
+    /*! @brief Number of tasks that was executed by this worker. */
+    std::atomic<unsigned long> _number_of_tasks;
+
+    /*! @brief Number of tasks that was stolen by this worker. */
+    std::atomic<unsigned long> _number_of_steals;
+
+    /*! @brief Number of steal attempts that found an empty deque. */
+    std::atomic<unsigned long> _number_of_failed_steals;
+
+    /*! @brief Time spent executing tasks (in ns). */
+    std::atomic<uint64_t> _busy_time;
+
+    /*! @brief Padding that keeps the counters of different workers on
+     *  different cache lines. */
+    char _padding[64];
+
+    /**
+     * @brief Empty constructor.
+     */
+    inline Worker()
+        : _number_of_tasks(0), _number_of_steals(0),
+          _number_of_failed_steals(0), _busy_time(0) {}
+  };
+
+  /*! @brief Workers. */
+  std::vector<std::unique_ptr<Worker>> _workers;
+
+  /*! @brief Worker threads. */
+  std::vector<std::thread> _threads;
+
+  /*! @brief Seed for the random generators used to choose victims. */
+  const uint64_t _seed;
+
+  /*! @brief Number of tasks that is queued in any of the deques. */
+  std::atomic<unsigned long> _number_of_queued_tasks;
+
+  /*! @brief Number of tasks that was submitted but did not finish yet. */
+  std::atomic<unsigned long> _number_of_unfinished_tasks;
+
+  /*! @brief Worker that receives the next task submitted from outside the
+   *  pool. */
+  std::atomic<unsigned int> _next_worker;
+
+  /*! @brief Should the worker threads stop? */
+  bool _stop;
+
+  /*! @brief Mutex used to put workers and waiting threads to sleep. */
+  std::mutex _sleep_mutex;
+
+  /*! @brief Condition variable used to wake up sleeping workers. */
+  std::condition_variable _work_available;
+
+  /*! @brief Condition variable used to wake up threads waiting in wait(). */
+  std::condition_variable _all_done;
+
+  /*! @brief Start of the period covered by the statistics. */
+  std::chrono::steady_clock::time_point _statistics_start;
+
+  /*! @brief End of the period covered by the statistics: the last time
+   *  wait() returned. */
+  std::chrono::steady_clock::time_point _statistics_end;
+
+  void run(unsigned int worker);
+  bool pop(unsigned int worker, Task &task);
+  bool steal(unsigned int worker, uint32_t victim, Task &task);
+  void push(unsigned int worker, Task &&task);
+  void wake_up(bool all);
+
+public:
+  WorkStealingPool(unsigned int number_of_workers = 0, uint64_t seed = 42);
+  ~WorkStealingPool();
+
+  unsigned int get_number_of_workers() const;
+
+  void submit(Task task);
+  void wait();
+  void run_batch(unsigned long number_of_tasks, BatchTask task);
+
+  void reset_statistics();
+  unsigned long get_number_of_tasks(unsigned int worker) const;
+  unsigned long get_number_of_steals(unsigned int worker) const;
+  unsigned long get_number_of_failed_steals(unsigned int worker) const;
+  double get_busy_time(unsigned int worker) const;
+  double get_utilization(unsigned int worker) const;
+};
+
+#endif // OPENSET_WORKSTEALINGPOOL_HPP
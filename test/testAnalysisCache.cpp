@@ -0,0 +1,247 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testAnalysisCache.cpp
+ *
+ * @brief Unit test for BoardHash and the AnalysisCache class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../analysis/AnalysisCache.hpp"
+#include "../analysis/BoardHash.hpp"
+#include "../engine/CardManager.hpp"
+#include "../engine/RandomGenerator.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+
+/**
+ * @brief Count the stalls after taking the given set by trying all deals.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ * @param set Indices of the cards in the set.
+ * @return Number of deals that leave a board without sets.
+ */
+static uint32_t count_stalls(const unsigned char *board,
+                             unsigned char board_size,
+                             const unsigned char *set) {
+  unsigned char next_board[GameState::MAX_BOARD_SIZE + 3];
+  unsigned char next_board_size = 0;
+  CardMask mask;
+  for (unsigned char i = 0; i < board_size; ++i) {
+    mask.add(board[i]);
+    if (board[i] != set[0] && board[i] != set[1] && board[i] != set[2]) {
+      next_board[next_board_size] = board[i];
+      ++next_board_size;
+    }
+  }
+  uint32_t number_of_stalls = 0;
+  for (unsigned char a = 0; a < CardIndex::CARDINDEX_COUNTER; ++a) {
+    for (unsigned char b = a + 1; b < CardIndex::CARDINDEX_COUNTER; ++b) {
+      for (unsigned char c = b + 1; c < CardIndex::CARDINDEX_COUNTER; ++c) {
+        if (mask.contains(a) || mask.contains(b) || mask.contains(c)) {
+          continue;
+        }
+        next_board[next_board_size] = a;
+        next_board[next_board_size + 1] = b;
+        next_board[next_board_size + 2] = c;
+        if (!CardManager::has_set(next_board, next_board_size + 3)) {
+          ++number_of_stalls;
+        }
+      }
+    }
+  }
+  return number_of_stalls;
+}
+
+/**
+ * @brief Unit test for BoardHash and the AnalysisCache class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  // on this board, every set leaves a board that can stall
+  CardManager card_manager(41);
+  const GameState &state = card_manager.get_state();
+  unsigned char board[GameState::MAX_BOARD_SIZE];
+  const unsigned char board_size = state._main_deck_size;
+  for (unsigned char i = 0; i < board_size; ++i) {
+    board[i] = state._main_deck[i];
+  }
+
+  // the hash does not depend on the slot order
+  RandomGenerator random_generator(42);
+  unsigned char shuffled_board[GameState::MAX_BOARD_SIZE];
+  for (unsigned char i = 0; i < board_size; ++i) {
+    shuffled_board[i] = board[i];
+  }
+  random_generator.shuffle(shuffled_board, board_size);
+  assert(BoardHash::get_hash(shuffled_board, board_size) ==
+         BoardHash::get_hash(board, board_size));
+  assert(BoardHash::get_hash(board, board_size - 1) !=
+         BoardHash::get_hash(board, board_size));
+
+  // attribute permutations map sets onto sets
+  for (unsigned char p = 0; p < BoardHash::NUMBER_OF_PERMUTATIONS; ++p) {
+    const unsigned char inverse = BoardHash::get_inverse(p);
+    CardMask image;
+    for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER;
+         ++card) {
+      const unsigned char image_card = BoardHash::permute(card, p);
+      assert(BoardHash::permute(image_card, inverse) == card);
+      image.add(image_card);
+      for (unsigned char other = card + 1;
+           other < CardIndex::CARDINDEX_COUNTER; ++other) {
+        assert(CardIndex::ClassicRules::get_third_card(
+                   image_card, BoardHash::permute(other, p)) ==
+               BoardHash::permute(
+                   CardIndex::ClassicRules::get_third_card(card, other), p));
+      }
+    }
+    assert(image.count() == CardIndex::CARDINDEX_COUNTER);
+  }
+  // permutation 1 swaps the two most significant attributes: the number of
+  // symbols and the colour
+  assert(BoardHash::permute(27, BoardHash::IDENTITY_PERMUTATION) == 27);
+  assert(BoardHash::permute(27, 1) == 9);
+  assert(BoardHash::permute(1, 1) == 1);
+
+  // the symmetric hash does not depend on the attribute order
+  unsigned char permuted_board[GameState::MAX_BOARD_SIZE];
+  for (unsigned char i = 0; i < board_size; ++i) {
+    permuted_board[i] = BoardHash::permute(shuffled_board[i], 17);
+  }
+  assert(BoardHash::get_symmetric_hash(permuted_board, board_size) ==
+         BoardHash::get_symmetric_hash(board, board_size));
+  assert(BoardHash::get_hash(permuted_board, board_size) !=
+         BoardHash::get_hash(board, board_size));
+
+  // the analysis agrees with a brute force count
+  const BoardAnalysis analysis = AnalysisCache::analyze(board, board_size);
+  assert(analysis._number_of_sets == card_manager.count_sets());
+  assert(analysis._number_of_stalls > 0);
+  assert(analysis._number_of_deals == 69 * 68 * 67 / 6);
+  assert(CardIndex::ClassicRules::is_set(analysis._best_move[0],
+                                         analysis._best_move[1],
+                                         analysis._best_move[2]));
+  assert(analysis._number_of_stalls ==
+         count_stalls(board, board_size, analysis._best_move));
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  const unsigned char number_of_sets = card_manager.find_all_sets(sets);
+  for (unsigned char i = 0; i < number_of_sets; ++i) {
+    const unsigned char set[3] = {board[sets[3 * i]], board[sets[3 * i + 1]],
+                                  board[sets[3 * i + 2]]};
+    assert(analysis._number_of_stalls <= count_stalls(board, board_size, set));
+  }
+
+  // a board without sets
+  unsigned char set_free_board[GameState::MAX_BOARD_SIZE];
+  unsigned char set_free_board_size = 0;
+  for (unsigned char card = 0; set_free_board_size < 12; ++card) {
+    set_free_board[set_free_board_size] = card;
+    if (!CardManager::has_set(set_free_board, set_free_board_size + 1)) {
+      ++set_free_board_size;
+    }
+  }
+  const BoardAnalysis set_free_analysis =
+      AnalysisCache::analyze(set_free_board, set_free_board_size);
+  assert(set_free_analysis._number_of_sets == 0);
+  assert(set_free_analysis._best_move[0] == BoardAnalysis::NO_MOVE);
+  assert(set_free_analysis._number_of_stalls < 69 * 68 * 67 / 6);
+
+  // the cache survives the process that created it
+  std::remove("test_analysis.cache");
+  {
+    AnalysisCache cache("test_analysis.cache", 1000);
+    assert(cache.is_valid());
+    assert(!cache.is_symmetric());
+    assert(cache.get_capacity() == 1024);
+    BoardAnalysis cached_analysis;
+    const bool found = cache.lookup(board, board_size, cached_analysis);
+    assert(!found);
+    cached_analysis = cache.get_analysis(board, board_size);
+    assert(cached_analysis._number_of_stalls == analysis._number_of_stalls);
+    assert(cache.get_number_of_entries() == 1);
+    assert(cache.get_number_of_misses() == 2);
+  }
+  {
+    AnalysisCache cache("test_analysis.cache", 16, true);
+    assert(cache.is_valid());
+    assert(!cache.is_symmetric());
+    assert(cache.get_capacity() == 1024);
+    BoardAnalysis cached_analysis;
+    bool found = cache.lookup(shuffled_board, board_size, cached_analysis);
+    assert(found);
+    assert(cache.get_number_of_hits() == 1);
+    assert(cached_analysis._number_of_sets == analysis._number_of_sets);
+    assert(cached_analysis._number_of_stalls == analysis._number_of_stalls);
+    assert(cached_analysis._best_move[0] == analysis._best_move[0]);
+    found = cache.lookup(permuted_board, board_size, cached_analysis);
+    assert(!found);
+  }
+
+  // boards that only differ by an attribute permutation share an entry in a
+  // symmetric cache, and the best move is mapped onto the board
+  std::remove("test_symmetric_analysis.cache");
+  {
+    AnalysisCache cache("test_symmetric_analysis.cache", 16, true);
+    assert(cache.is_symmetric());
+    bool inserted = cache.insert(board, board_size, analysis);
+    assert(inserted);
+    BoardAnalysis cached_analysis;
+    const bool found =
+        cache.lookup(permuted_board, board_size, cached_analysis);
+    assert(found);
+    assert(cache.get_number_of_entries() == 1);
+    assert(cached_analysis._number_of_stalls == analysis._number_of_stalls);
+    for (unsigned char i = 0; i < 3; ++i) {
+      assert(cached_analysis._best_move[i] ==
+             BoardHash::permute(analysis._best_move[i], 17));
+    }
+    assert(cached_analysis._number_of_stalls ==
+           count_stalls(permuted_board, board_size,
+                        cached_analysis._best_move));
+
+    // the table only accepts entries while it is less than 3/4 full
+    for (unsigned char i = 0; i < 11; ++i) {
+      inserted = cache.insert(board, i + 1, analysis);
+      assert(inserted);
+    }
+    assert(cache.get_number_of_entries() == 12);
+    inserted =
+        cache.insert(set_free_board, set_free_board_size, set_free_analysis);
+    assert(!inserted);
+    assert(cache.get_number_of_entries() == 12);
+  }
+
+  // files that are not caches are rejected
+  {
+    std::ofstream file("test_invalid.cache");
+    file << "this is not a cache, but it is long enough to hold a header "
+            "of 64 bytes.";
+  }
+  AnalysisCache invalid_cache("test_invalid.cache");
+  assert(!invalid_cache.is_valid());
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testBot.cpp
+ *
+ * @brief Unit test for the Bot classes.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../bots/HumanBot.hpp"
+#include "../bots/InstantBot.hpp"
+#include "../bots/LookaheadBot.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Check that the given move is a valid set on the main deck.
+ *
+ * @param card_manager Game.
+ * @param move BotMove.
+ */
+static void check_move(const CardManager &card_manager, const BotMove &move) {
+  const unsigned char board_size = card_manager.get_board().size();
+  assert(move._positions[0] < move._positions[1]);
+  assert(move._positions[1] < move._positions[2]);
+  assert(move._positions[2] < board_size);
+  assert(CardManager::is_set(card_manager.get_card(move._positions[0]),
+                             card_manager.get_card(move._positions[1]),
+                             card_manager.get_card(move._positions[2])));
+}
+
+/**
+ * @brief Let the given bot play a complete game.
+ *
+ * @param bot Bot.
+ * @param seed Seed of the game.
+ * @return Number of sets that was taken.
+ */
+static unsigned char play_game(Bot &bot, uint64_t seed) {
+  CardManager card_manager(seed);
+  BotMove move;
+  unsigned char number_of_sets = 0;
+  while (bot.find_move(card_manager, move)) {
+    check_move(card_manager, move);
+    Bot::play_move(card_manager, move);
+    ++number_of_sets;
+  }
+  // only the human bot can give up while there are still sets
+  return number_of_sets;
+}
+
+/**
+ * @brief Unit test for the Bot classes.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+
+  // the instant bot plays the same game as taking the first set in the set
+  // index
+  {
+    InstantBot bot;
+    CardManager card_manager(42);
+    BotMove move;
+    while (bot.find_move(card_manager, move)) {
+      assert(move._delay.count() == 0);
+      check_move(card_manager, move);
+      Bot::play_move(card_manager, move);
+    }
+    assert(card_manager.set_count() == 0);
+  }
+
+  // the lookahead bot takes the set that leaves the most sets behind, and
+  // still moves if its budget is zero
+  {
+    LookaheadBot bot;
+    for (uint64_t seed = 1; seed <= 20; ++seed) {
+      CardManager card_manager(seed);
+      BotMove move;
+      const bool found = bot.find_move(card_manager, move);
+      assert(found);
+      check_move(card_manager, move);
+      const SetIndex &sets = card_manager.get_sets();
+      const IndexSpan board = card_manager.get_board_indices();
+      const unsigned char chosen[3] = {board[move._positions[0]],
+                                       board[move._positions[1]],
+                                       board[move._positions[2]]};
+      const unsigned char score = LookaheadBot::evaluate(board, chosen);
+      for (unsigned char i = 0; i < sets.set_count(); ++i) {
+        assert(LookaheadBot::evaluate(board, sets.get_set(i)) <= score);
+      }
+    }
+    LookaheadBot impatient_bot(std::chrono::nanoseconds(0));
+    CardManager card_manager(1);
+    BotMove move;
+    const bool found = impatient_bot.find_move(card_manager, move);
+    assert(found);
+    check_move(card_manager, move);
+    const unsigned char number_of_sets = play_game(bot, 7);
+    assert(number_of_sets > 0);
+  }
+
+  // the human bot is reproducible, has a delay that respects its budget, and
+  // gives up if the budget is too small
+  {
+    HumanBot bot1(3);
+    HumanBot bot2(3);
+    CardManager card_manager(3);
+    BotMove move1, move2;
+    for (unsigned int i = 0; i < 10; ++i) {
+      const bool found1 = bot1.find_move(card_manager, move1);
+      const bool found2 = bot2.find_move(card_manager, move2);
+      assert(found1 && found2);
+      check_move(card_manager, move1);
+      assert(move1._positions[0] == move2._positions[0]);
+      assert(move1._positions[1] == move2._positions[1]);
+      assert(move1._positions[2] == move2._positions[2]);
+      assert(move1._delay == move2._delay);
+      assert(move1._delay >= std::chrono::milliseconds(500));
+      assert(move1._delay <= bot1.get_budget());
+      Bot::play_move(card_manager, move1);
+    }
+    HumanBot slow_bot(3, std::chrono::milliseconds(100));
+    const bool found = slow_bot.find_move(card_manager, move1);
+    assert(!found);
+  }
+
+  return 0;
+}
@@ -0,0 +1,260 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testCapEnumerator.cpp
+ *
+ * @brief Unit test for the AffineSpace and CapEnumerator classes.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../analysis/AffineSpace.hpp"
+#include "../analysis/CapEnumerator.hpp"
+#include "../engine/Card.hpp"
+#include "../engine/CardManager.hpp"
+#include "../engine/RandomGenerator.hpp"
+#include "../parallel/WorkStealingPool.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+/*! @brief Number of set-free boards of every size, as found in the
+ *  literature. */
+static const uint64_t NUMBER_OF_CAPS[AffineSpace::MAXIMUM_CAP_SIZE + 1] = {
+    1ull,
+    81ull,
+    3240ull,
+    84240ull,
+    1579500ull,
+    22441536ull,
+    247615056ull,
+    2144076480ull,
+    14587567020ull,
+    77541824880ull,
+    318294370368ull,
+    991227481920ull,
+    2284535476080ull,
+    3764369026080ull,
+    4217827554720ull,
+    2970003246912ull,
+    1141342138404ull,
+    176310866160ull,
+    6482268000ull,
+    13646880ull,
+    682344ull};
+
+/**
+ * @brief Apply a random affine transformation to the given set of points.
+ *
+ * @param points Set of points.
+ * @param random_generator Random generator.
+ * @return Image of the points.
+ */
+static CardMask transform(const CardMask &points,
+                          RandomGenerator &random_generator) {
+  const AffineSpace &space = AffineSpace::get_space();
+  // card 0 is the origin; we draw random images for the unit vectors until
+  // they are linearly independent
+  unsigned char columns[AffineSpace::DIMENSION];
+  CardMask basis;
+  do {
+    basis = CardMask();
+    basis.add(0);
+    for (unsigned char i = 0; i < AffineSpace::DIMENSION; ++i) {
+      columns[i] = random_generator.get_random_integer(
+          AffineSpace::NUMBER_OF_POINTS);
+      basis.add(columns[i]);
+    }
+  } while (basis.count() < AffineSpace::DIMENSION + 1 ||
+           space.get_dimension(basis) < AffineSpace::DIMENSION);
+  const unsigned char translation =
+      random_generator.get_random_integer(AffineSpace::NUMBER_OF_POINTS);
+
+  CardMask image;
+  for (unsigned char point = 0; point < AffineSpace::NUMBER_OF_POINTS;
+       ++point) {
+    if (!points.contains(point)) {
+      continue;
+    }
+    unsigned char image_point = translation;
+    for (unsigned char i = 0; i < AffineSpace::DIMENSION; ++i) {
+      for (unsigned char j = 0; j < space.get_coordinate(point, i); ++j) {
+        image_point = space.get_sum(image_point, columns[i]);
+      }
+    }
+    image.add(image_point);
+  }
+  return image;
+}
+
+/**
+ * @brief Unit test for the AffineSpace and CapEnumerator classes.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  const AffineSpace &space = AffineSpace::get_space();
+
+  // lines are sets, and coordinates are card properties
+  for (unsigned char a = 0; a < AffineSpace::NUMBER_OF_POINTS; ++a) {
+    const Card &card = Card::get_card(a);
+    assert(space.get_coordinate(a, 0) == card.get_number_of_symbols() - 1);
+    assert(space.get_coordinate(a, 1) == card.get_colour());
+    assert(space.get_coordinate(a, 2) == card.get_symbol());
+    assert(space.get_coordinate(a, 3) == card.get_fill());
+    for (unsigned char b = 0; b < AffineSpace::NUMBER_OF_POINTS; ++b) {
+      assert(space.get_sum(space.get_difference(a, b), b) == a);
+      if (a != b) {
+        assert(CardManager::is_set(card, Card::get_card(b),
+                                   Card::get_card(space.get_third(a, b))));
+      }
+    }
+  }
+
+  // dimensions of flats
+  CardMask points;
+  points.add(0);
+  assert(space.get_dimension(points) == 0);
+  points.add(1);
+  points.add(2);
+  assert(space.get_dimension(points) == 1);
+  assert(!space.is_cap(points));
+  points.add(3);
+  assert(space.get_dimension(points) == 2);
+  points.add(9);
+  assert(space.get_dimension(points) == 3);
+  points.add(26);
+  assert(space.get_dimension(points) == 3);
+  points.add(27);
+  assert(space.get_dimension(points) == 4);
+
+  // a single point is fixed by all linear maps
+  uint64_t number_of_automorphisms;
+  points = CardMask();
+  points.add(40);
+  CardMask canonical_form =
+      space.get_canonical_form(points, number_of_automorphisms);
+  assert(canonical_form.count() == 1);
+  assert(number_of_automorphisms ==
+         AffineSpace::NUMBER_OF_TRANSFORMATIONS /
+             AffineSpace::NUMBER_OF_POINTS);
+
+  // canonical forms do not change under random affine transformations
+  RandomGenerator random_generator(42);
+  for (unsigned int test = 0; test < 200; ++test) {
+    unsigned char cards[AffineSpace::NUMBER_OF_POINTS];
+    for (unsigned char i = 0; i < AffineSpace::NUMBER_OF_POINTS; ++i) {
+      cards[i] = i;
+    }
+    random_generator.shuffle(cards, AffineSpace::NUMBER_OF_POINTS);
+    const unsigned char size = 1 + test % AffineSpace::MAXIMUM_CAP_SIZE;
+    CardMask cap;
+    for (unsigned char i = 0;
+         i < AffineSpace::NUMBER_OF_POINTS && cap.count() < size; ++i) {
+      CardMask extended_cap = cap;
+      extended_cap.add(cards[i]);
+      if (space.is_cap(extended_cap)) {
+        cap = extended_cap;
+      }
+    }
+
+    canonical_form = space.get_canonical_form(cap, number_of_automorphisms);
+    assert(canonical_form.count() == cap.count());
+    assert(space.is_cap(canonical_form));
+    assert(AffineSpace::NUMBER_OF_TRANSFORMATIONS % number_of_automorphisms ==
+           0);
+    for (unsigned int i = 0; i < 5; ++i) {
+      const CardMask image = transform(cap, random_generator);
+      uint64_t image_automorphisms;
+      const CardMask image_canonical_form =
+          space.get_canonical_form(image, image_automorphisms);
+      assert(image_canonical_form == canonical_form);
+      assert(image_automorphisms == number_of_automorphisms);
+    }
+  }
+
+  // exact counts, interrupted after 8 cards and resumed from the checkpoint
+  std::remove("test_caps.checkpoint");
+  WorkStealingPool pool(2);
+  {
+    CapEnumerator enumerator(pool, "test_caps.checkpoint", 16);
+    const bool loaded = enumerator.load_checkpoint();
+    assert(!loaded);
+    const bool checkpoints_written = enumerator.run(8);
+    assert(checkpoints_written);
+    assert(enumerator.get_size() == 8);
+    for (unsigned char size = 0; size <= 8; ++size) {
+      assert(enumerator.get_number_of_caps(size) == NUMBER_OF_CAPS[size]);
+    }
+  }
+  CapEnumerator enumerator(pool, "test_caps.checkpoint", 16);
+  const bool loaded = enumerator.load_checkpoint();
+  assert(loaded);
+  assert(enumerator.get_size() == 8);
+  assert(enumerator.get_number_of_classes(8) == 33);
+  assert(enumerator.get_classes().size() == 33);
+  const bool checkpoints_written = enumerator.run();
+  assert(checkpoints_written);
+  assert(enumerator.get_size() == AffineSpace::MAXIMUM_CAP_SIZE);
+  for (unsigned char size = 0; size <= AffineSpace::MAXIMUM_CAP_SIZE;
+       ++size) {
+    assert(enumerator.get_number_of_caps(size) == NUMBER_OF_CAPS[size]);
+  }
+  assert(enumerator.get_number_of_classes(12) == 1437);
+  // the largest set-free board is unique up to symmetry
+  assert(enumerator.get_number_of_classes(20) == 1);
+  assert(enumerator.get_classes()[0]._number_of_automorphisms == 2880);
+
+  assert(CapEnumerator::get_number_of_boards(3) == 85320);
+  assert(CapEnumerator::get_number_of_boards(12) == 70724320184700ull);
+  assert(std::abs(enumerator.get_probability(12) - 0.0323019) < 1.e-6);
+
+  // corrupt checkpoints are rejected without allocating memory for the
+  // number of classes in their header
+  std::vector<char> checkpoint;
+  {
+    std::ifstream file("test_caps.checkpoint", std::ios::binary);
+    checkpoint.assign(std::istreambuf_iterator<char>(file),
+                      std::istreambuf_iterator<char>());
+  }
+  assert(checkpoint.size() > sizeof(CapCheckpointHeader));
+  CapCheckpointHeader header;
+  std::memcpy(&header, checkpoint.data(), sizeof(header));
+  header._number_of_classes = uint64_t(1) << 60;
+  header._next_class = 0;
+  std::memcpy(checkpoint.data(), &header, sizeof(header));
+  for (unsigned char truncate = 0; truncate < 2; ++truncate) {
+    {
+      std::ofstream file("test_caps.checkpoint", std::ios::binary);
+      file.write(checkpoint.data(), checkpoint.size() - truncate);
+    }
+    CapEnumerator corrupt_enumerator(pool, "test_caps.checkpoint");
+    const bool corrupt_loaded = corrupt_enumerator.load_checkpoint();
+    assert(!corrupt_loaded);
+    assert(corrupt_enumerator.get_size() == 0);
+  }
+  std::remove("test_caps.checkpoint");
+
+  return 0;
+}
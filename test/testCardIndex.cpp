@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file testCardIndex.cpp
+ *
+ * @brief Unit test for the packed card encoding and the third card table.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/Card.hpp"
+#include "../engine/CardIndex.hpp"
+#include "../engine/CardManager.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Check if the given property values make up a valid set property.
+ *
+ * @param a First value.
+ * @param b Second value.
+ * @param c Third value.
+ * @return True if all values are the same or all values are different.
+ */
+static bool is_set_property(int a, int b, int c) {
+  return (a == b && a == c) || (a != b && a != c && b != c);
+}
+
+/**
+ * @brief Unit test for the packed card encoding and the third card table.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+
+  // check that the encoding is a bijection between properties and indices
+  for (unsigned char index = 0; index < CardIndex::CARDINDEX_COUNTER;
+       ++index) {
+    Card card(index);
+    assert(card.get_index() == index);
+    Card copy(card.get_number_of_symbols(), card.get_colour(),
+              card.get_symbol(), card.get_fill());
+    assert(copy.get_index() == index);
+    assert(card.get_number_of_symbols() >= 1 &&
+           card.get_number_of_symbols() <= CardProperties::CARDNUMBER_COUNTER);
+    assert(card.get_colour() < CardProperties::CARDCOLOUR_COUNTER);
+    assert(card.get_symbol() < CardProperties::CARDSYMBOL_COUNTER);
+    assert(card.get_fill() < CardProperties::CARDFILL_COUNTER);
+  }
+
+  // check the third card table against the explicit set rules
+  for (unsigned char index1 = 0; index1 < CardIndex::CARDINDEX_COUNTER;
+       ++index1) {
+    for (unsigned char index2 = 0; index2 < CardIndex::CARDINDEX_COUNTER;
+         ++index2) {
+      Card card1(index1);
+      Card card2(index2);
+      unsigned char third_card = CardIndex::get_third_card(index1, index2);
+      assert(third_card < CardIndex::CARDINDEX_COUNTER);
+      assert(third_card == CardIndex::get_third_card(index2, index1));
+      for (unsigned char index3 = 0; index3 < CardIndex::CARDINDEX_COUNTER;
+           ++index3) {
+        Card card3(index3);
+        bool reference =
+            is_set_property(card1.get_number_of_symbols(),
+                            card2.get_number_of_symbols(),
+                            card3.get_number_of_symbols()) &&
+            is_set_property(card1.get_colour(), card2.get_colour(),
+                            card3.get_colour()) &&
+            is_set_property(card1.get_symbol(), card2.get_symbol(),
+                            card3.get_symbol()) &&
+            is_set_property(card1.get_fill(), card2.get_fill(),
+                            card3.get_fill());
+        assert(CardIndex::is_set(index1, index2, index3) == reference);
+        assert(CardManager::is_set(card1, card2, card3) == reference);
+        assert((third_card == index3) == reference);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -25,9 +25,71 @@
  */
 
 #include "../engine/CardManager.hpp"
+#include "../engine/CardMask.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <random>
+
+/**
+ * @brief Check the set finding functions for the given board against a brute
+ * force search over all triples of cards.
+ *
+ * @param board Indices of the cards on the board.
+ * @param board_size Number of cards on the board.
+ */
+static void check_find_all_sets(const unsigned char *board,
+                                unsigned char board_size) {
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  const unsigned char number_of_sets =
+      CardManager::find_all_sets(board, board_size, sets);
+
+  unsigned char reference_number_of_sets = 0;
+  for (unsigned char i = 0; i < board_size; ++i) {
+    for (unsigned char j = i + 1; j < board_size; ++j) {
+      for (unsigned char k = j + 1; k < board_size; ++k) {
+        if (CardIndex::is_set(board[i], board[j], board[k])) {
+          assert(reference_number_of_sets < number_of_sets);
+          assert(sets[3 * reference_number_of_sets] == i);
+          assert(sets[3 * reference_number_of_sets + 1] == j);
+          assert(sets[3 * reference_number_of_sets + 2] == k);
+          ++reference_number_of_sets;
+        }
+      }
+    }
+  }
+  assert(number_of_sets == reference_number_of_sets);
+  assert(CardManager::count_sets(board, board_size) == number_of_sets);
+  assert(CardManager::has_set(board, board_size) == (number_of_sets > 0));
+}
+
+/**
+ * @brief Check that the set index of the given CardManager contains exactly
+ * the sets on its main deck.
+ *
+ * @param card_manager CardManager.
+ */
+static void check_set_index(const CardManager &card_manager) {
+  IndexSpan board = card_manager.get_board_indices();
+  const SetIndex &set_index = card_manager.get_sets();
+  assert(card_manager.set_count() ==
+         CardManager::count_sets(board.begin(), board.size()));
+  assert(set_index.set_count() == card_manager.set_count());
+
+  CardMask board_mask;
+  for (unsigned char card : board) {
+    board_mask.add(card);
+  }
+  assert(set_index.get_cards() == board_mask);
+  for (unsigned char set = 0; set < set_index.set_count(); ++set) {
+    const unsigned char *cards = set_index.get_set(set);
+    assert(cards[0] < cards[1] && cards[1] < cards[2]);
+    assert(board_mask.contains(cards[0]) && board_mask.contains(cards[1]) &&
+           board_mask.contains(cards[2]));
+    assert(CardIndex::is_set(cards[0], cards[1], cards[2]));
+  }
+}
 
 /**
  * @brief Unit test for the CardManager class.
@@ -41,7 +103,12 @@ int main(int argc, char **argv) {
 
   std::vector<Card> deck = card_manager.get_deck();
 
-  assert(deck.size() == 12);
+  // extra cards are only dealt if the first 12 cards do not contain a set
+  assert(deck.size() >= CardManager::BASE_BOARD_SIZE);
+  assert(deck.size() == CardManager::BASE_BOARD_SIZE ||
+         !card_manager.has_set() ||
+         !CardManager::has_set(card_manager.get_board_indices().begin(),
+                               CardManager::BASE_BOARD_SIZE));
   for (unsigned char card = 0; card < deck.size(); ++card) {
     unsigned char number_of_symbols = deck[card].get_number_of_symbols();
     CardProperties::CardColour colour = deck[card].get_colour();
@@ -53,5 +120,207 @@ int main(int argc, char **argv) {
               << CardProperties::get_card_fill(fill) << std::endl;
   }
 
+  // the board view and index span give access to the same cards as get_deck()
+  BoardView board = card_manager.get_board();
+  IndexSpan board_indices = card_manager.get_board_indices();
+  assert(board.size() == deck.size());
+  assert(board_indices.size() == deck.size());
+  unsigned char position = 0;
+  for (const Card &card : board) {
+    assert(card.get_index() == deck[position].get_index());
+    assert(board[position].get_index() == deck[position].get_index());
+    assert(board_indices[position] == deck[position].get_index());
+    assert(&card == &card_manager.get_card(position));
+    ++position;
+  }
+  assert(position == deck.size());
+
+  // cards are stored in a single shared table
+  assert(sizeof(Card) == 1);
+  for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER; ++card) {
+    assert(Card::get_card(card).get_index() == card);
+  }
+  assert(&card_manager.get_card(0) == &Card::get_card(deck[0].get_index()));
+
+  // the selection is stored per game
+  {
+    CardManager game1(1);
+    CardManager game2(1);
+    game1.click_card(3);
+    assert(game1.is_clicked(3));
+    assert(!game2.is_clicked(3));
+    game1.click_card(5);
+    const uint32_t unclick_dirty = game1.click_card(3);
+    assert(unclick_dirty == (uint32_t(1) << 3));
+    assert(!game1.is_clicked(3));
+    assert(game1.is_clicked(5));
+
+    // a rejected set unclicks the three cards, which are all dirty
+    unsigned char no_set = 2;
+    while (CardManager::is_set(game2.get_card(0), game2.get_card(1),
+                               game2.get_card(no_set))) {
+      ++no_set;
+    }
+    game2.click_card(0);
+    game2.click_card(1);
+    const uint32_t reject_dirty = game2.click_card(no_set);
+    assert(reject_dirty == (3 | (uint32_t(1) << no_set)));
+    assert(!game2.is_clicked(0) && !game2.is_clicked(1) &&
+           !game2.is_clicked(no_set));
+    assert(game2.get_card(0).get_index() == game1.get_card(0).get_index());
+  }
+
+  // snapshots restore the full state of a game, and forks are independent
+  // copies of a game
+  {
+    CardManager game(7);
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    game.click_card(0);
+    const GameState state = game.snapshot();
+    assert(sizeof(state) <= 128);
+    const unsigned char number_of_sets = game.set_count();
+    CardManager fork = game.fork();
+    assert(fork.get_seed() == game.get_seed());
+    assert(fork.snapshot() == state);
+    assert(fork.is_clicked(0));
+    check_set_index(fork);
+
+    // play the fork until the end: the original game does not change
+    fork.click_card(0);
+    while (fork.find_all_sets(sets) > 0) {
+      fork.click_card(sets[0]);
+      fork.click_card(sets[1]);
+      fork.click_card(sets[2]);
+      check_set_index(fork);
+    }
+    assert(game.snapshot() == state);
+    assert(!(fork.snapshot() == state));
+
+    // take a set in the original game, and then go back
+    game.click_card(0);
+    const unsigned char number_of_found_sets = game.find_all_sets(sets);
+    assert(number_of_found_sets > 0);
+    game.click_card(sets[0]);
+    game.click_card(sets[1]);
+    game.click_card(sets[2]);
+    assert(!(game.snapshot() == state));
+    game.restore(state);
+    assert(game.snapshot() == state);
+    assert(game.set_count() == number_of_sets);
+    check_set_index(game);
+
+    // restoring the final state of the fork ends the original game as well
+    game.restore(fork.snapshot());
+    assert(!game.has_set());
+    check_set_index(game);
+  }
+
+  // check that the same seed deals the same game, and that different seeds
+  // deal different games
+  CardManager seeded_manager(card_manager.get_seed());
+  std::vector<Card> seeded_deck = seeded_manager.get_deck();
+  for (unsigned char card = 0; card < deck.size(); ++card) {
+    assert(seeded_deck[card].get_index() == deck[card].get_index());
+  }
+  CardManager other_manager(card_manager.get_seed() + 1);
+  std::vector<Card> other_deck = other_manager.get_deck();
+  bool same_deck = true;
+  for (unsigned char card = 0; card < deck.size(); ++card) {
+    same_deck &= (other_deck[card].get_index() == deck[card].get_index());
+  }
+  assert(!same_deck);
+
+  // take sets until the game is over: every card should be dealt exactly once,
+  // and the dirty masks should contain exactly the cards that changed. Boards
+  // without a set are expanded until the card stack is empty
+  bool game_finished = false;
+  bool board_expanded = false;
+  for (uint64_t seed = 0; seed < 100; ++seed) {
+    CardManager game(seed);
+    board_expanded |= game.get_board().size() > CardManager::BASE_BOARD_SIZE;
+    CardMask dealt_cards;
+    unsigned char number_of_cards_taken = 0;
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    std::vector<Card> game_deck = game.get_deck();
+    for (unsigned char card = 0; card < game_deck.size(); ++card) {
+      dealt_cards.add(game_deck[card].get_index());
+    }
+    check_set_index(game);
+    while (game.find_all_sets(sets) > 0) {
+      assert(game.has_set());
+      const uint32_t first_dirty = game.click_card(sets[0]);
+      assert(first_dirty == (uint32_t(1) << sets[0]));
+      const uint32_t second_dirty = game.click_card(sets[1]);
+      assert(second_dirty == (uint32_t(1) << sets[1]));
+      const uint32_t dirty = game.click_card(sets[2]);
+      number_of_cards_taken += 3;
+      std::vector<Card> new_game_deck = game.get_deck();
+      uint32_t expected_dirty = (uint32_t(1) << sets[0]) |
+                                (uint32_t(1) << sets[1]) |
+                                (uint32_t(1) << sets[2]);
+      for (unsigned char card = 0;
+           card < std::max(game_deck.size(), new_game_deck.size()); ++card) {
+        if (card >= game_deck.size() || card >= new_game_deck.size() ||
+            new_game_deck[card].get_index() != game_deck[card].get_index()) {
+          expected_dirty |= uint32_t(1) << card;
+        }
+      }
+      assert(dirty == expected_dirty);
+      check_set_index(game);
+      board_expanded |= new_game_deck.size() > game_deck.size();
+      game_deck = new_game_deck;
+      for (unsigned char card = 0; card < game_deck.size(); ++card) {
+        dealt_cards.add(game_deck[card].get_index());
+      }
+      // a board without a set is expanded, unless that is impossible
+      assert(game.has_set() ||
+             dealt_cards.count() == CardIndex::CARDINDEX_COUNTER ||
+             game_deck.size() == CardManager::MAX_BOARD_SIZE);
+    }
+    assert(!game.has_set() && game.set_count() == 0);
+    // every card that was dealt was either taken or is still on the board
+    assert(dealt_cards.count() == number_of_cards_taken + game_deck.size());
+    // the game only ends before all cards are dealt if the board has its
+    // maximum size
+    assert(dealt_cards.count() == CardIndex::CARDINDEX_COUNTER ||
+           game_deck.size() == CardManager::MAX_BOARD_SIZE);
+    game_finished |= (dealt_cards.count() == CardIndex::CARDINDEX_COUNTER);
+  }
+  // make sure we tested at least one game in which all cards were dealt, and
+  // at least one game in which extra cards were dealt
+  assert(game_finished);
+  assert(board_expanded);
+
+  // check the set finding functions on the main deck
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  unsigned char number_of_sets = card_manager.find_all_sets(sets);
+  assert(card_manager.count_sets() == number_of_sets);
+  assert(card_manager.has_set() == (number_of_sets > 0));
+  for (unsigned char set = 0; set < number_of_sets; ++set) {
+    assert(CardManager::is_set(deck[sets[3 * set]], deck[sets[3 * set + 1]],
+                               deck[sets[3 * set + 2]]));
+  }
+
+  // check the set finding functions on random boards of all supported sizes
+  unsigned char cards[CardIndex::CARDINDEX_COUNTER];
+  for (unsigned char card = 0; card < CardIndex::CARDINDEX_COUNTER; ++card) {
+    cards[card] = card;
+  }
+  std::mt19937 random_generator(42);
+  for (unsigned int board = 0; board < 1000; ++board) {
+    std::shuffle(cards, cards + CardIndex::CARDINDEX_COUNTER, random_generator);
+    check_find_all_sets(cards, 12);
+    check_find_all_sets(cards, 15);
+    check_find_all_sets(cards, CardManager::MAX_BOARD_SIZE);
+  }
+
+  // the 9 single red symbol cards make up a plane that contains 12 sets
+  unsigned char plane[9];
+  for (unsigned char card = 0; card < 9; ++card) {
+    plane[card] = card;
+  }
+  check_find_all_sets(plane, 9);
+  assert(CardManager::count_sets(plane, 9) == 12);
+
   return 0;
 }
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file testCardRenderer.cpp
+ *
+ * @brief Unit test for the CardRenderer class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/Card.hpp"
+#include "../visuals/CardRenderer.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+
+/**
+ * @brief Unit test for the CardRenderer class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  CardRenderer renderer;
+
+  // render a single card: the center of the card is covered by the middle
+  // symbol of the card, and the corners are transparent
+  cairo_surface_t *surface =
+      renderer.create_card_surface(Card::get_card(0), false, 100, 141);
+  assert(cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS);
+  cairo_surface_flush(surface);
+  const unsigned char *data = cairo_image_surface_get_data(surface);
+  const int stride = cairo_image_surface_get_stride(surface);
+  // ARGB32 pixels are stored as native endian 32-bit integers
+  const uint32_t corner = *reinterpret_cast<const uint32_t *>(data);
+  const uint32_t center =
+      *reinterpret_cast<const uint32_t *>(data + 70 * stride + 50 * 4);
+  assert((corner >> 24) == 0);
+  assert((center >> 24) == 255);
+  cairo_surface_destroy(surface);
+
+  // rendering more cards does not create new fill patterns
+  for (unsigned char index = 0; index < CardIndex::CARDINDEX_COUNTER;
+       ++index) {
+    surface = renderer.create_card_surface(Card::get_card(index), index & 1,
+                                           50, 70);
+    cairo_surface_destroy(surface);
+  }
+  assert(renderer.get_total_pattern_allocations() <=
+         CardProperties::CARDCOLOUR_COUNTER * CardProperties::CARDFILL_COUNTER);
+
+  // the symbol outlines are created once per card width
+  const unsigned long path_allocations = renderer.get_total_path_allocations();
+  assert(path_allocations <= 2 * CardProperties::CARDSYMBOL_COUNTER);
+  for (unsigned char index = 0; index < CardIndex::CARDINDEX_COUNTER;
+       ++index) {
+    surface = renderer.create_card_surface(Card::get_card(index), false, 50,
+                                           70);
+    cairo_surface_destroy(surface);
+  }
+  assert(renderer.get_total_path_allocations() == path_allocations);
+
+  // symbols outside the clip region are not drawn: the card with index 54 has
+  // 3 symbols, centered at 35.25, 70.5 and 105.75 pixels from the top
+  surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 100, 141);
+  cairo_t *cr = cairo_create(surface);
+  renderer.start_frame();
+  renderer.draw_card(cr, Card::get_card(54), false, 100, 141);
+  assert(renderer.get_frame_shapes_drawn() == 3);
+  assert(renderer.get_frame_shapes_skipped() == 0);
+  cairo_rectangle(cr, 0, 0, 100, 5);
+  cairo_clip(cr);
+  renderer.start_frame();
+  renderer.draw_card(cr, Card::get_card(54), false, 100, 141);
+  assert(renderer.get_frame_shapes_drawn() == 0);
+  assert(renderer.get_frame_shapes_skipped() == 3);
+  cairo_reset_clip(cr);
+  cairo_rectangle(cr, 0, 30, 100, 10);
+  cairo_clip(cr);
+  renderer.start_frame();
+  renderer.draw_card(cr, Card::get_card(54), false, 100, 141);
+  assert(renderer.get_frame_shapes_drawn() == 1);
+  assert(renderer.get_frame_shapes_skipped() == 2);
+  cairo_destroy(cr);
+  cairo_surface_destroy(surface);
+
+  // write a sprite sheet containing all cards
+  const bool written =
+      renderer.write_sprite_sheet("test_sprite_sheet.png", 50, 70);
+  assert(written);
+  std::ifstream file("test_sprite_sheet.png");
+  assert(file.good());
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testGameEngine.cpp
+ *
+ * @brief Unit test for the GameEngine class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/GameEngine.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+/**
+ * @brief Notify function that counts the number of calls.
+ *
+ * @param data Pointer to an std::atomic<unsigned int> counter.
+ */
+static void count_notifications(void *data) {
+  ++*static_cast<std::atomic<unsigned int> *>(data);
+}
+
+/**
+ * @brief Wait for the next notification from the engine.
+ *
+ * @param engine GameEngine.
+ * @return Notification.
+ */
+static EngineNotification wait_for_notification(GameEngine &engine) {
+  EngineNotification notification;
+  while (!engine.pop_notification(notification)) {
+    std::this_thread::yield();
+  }
+  return notification;
+}
+
+/**
+ * @brief Check that the board in the notification matches the given game.
+ *
+ * @param notification EngineNotification.
+ * @param card_manager CardManager.
+ */
+static void check_board(const EngineNotification &notification,
+                        const CardManager &card_manager) {
+  const GameState &state = card_manager.get_state();
+  assert(notification._main_deck_size == state._main_deck_size);
+  assert(notification._clicked == state._clicked);
+  for (unsigned char i = 0; i < state._main_deck_size; ++i) {
+    assert(notification._main_deck[i] == state._main_deck[i]);
+  }
+}
+
+/**
+ * @brief Unit test for the GameEngine class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  CardManager card_manager(42);
+  CardManager reference(42);
+  std::atomic<unsigned int> number_of_notify_calls(0);
+  {
+    GameEngine engine(card_manager, count_notifications,
+                      &number_of_notify_calls);
+
+    // every click results in exactly one notification, with the same dirty
+    // mask and board as a synchronous click
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    for (unsigned int move = 0; move < 10; ++move) {
+      const unsigned char number_of_sets = reference.find_all_sets(sets);
+      assert(number_of_sets > 0);
+      for (unsigned char i = 0; i < 3; ++i) {
+        const bool queued = engine.click_card(sets[i]);
+        assert(queued);
+        const EngineNotification notification = wait_for_notification(engine);
+        const uint32_t reference_dirty = reference.click_card(sets[i]);
+        assert(notification._dirty == reference_dirty);
+        check_board(notification, reference);
+      }
+    }
+
+    // clicks are queued while the engine is busy, and handled in order
+    const unsigned char number_of_sets = reference.find_all_sets(sets);
+    assert(number_of_sets > 0);
+    for (unsigned char i = 0; i < 3; ++i) {
+      const bool queued = engine.click_card(sets[i]);
+      assert(queued);
+    }
+    EngineNotification notification;
+    uint32_t dirty = 0;
+    for (unsigned char i = 0; i < 3; ++i) {
+      notification = wait_for_notification(engine);
+      dirty |= notification._dirty;
+    }
+    uint32_t reference_dirty = 0;
+    for (unsigned char i = 0; i < 3; ++i) {
+      reference_dirty |= reference.click_card(sets[i]);
+    }
+    assert(dirty == reference_dirty);
+    check_board(notification, reference);
+
+    // clicks on cards that are no longer on the board are ignored
+    const bool queued = engine.click_card(CardManager::MAX_BOARD_SIZE);
+    assert(queued);
+    notification = wait_for_notification(engine);
+    assert(notification._dirty == 0);
+    check_board(notification, reference);
+
+    assert(engine.get_number_of_commands() == 34);
+    assert(engine.get_number_of_notifications() == 34);
+    assert(engine.get_number_of_dropped_commands() == 0);
+    assert(engine.get_command_queue_depth() == 0);
+    assert(engine.get_notification_queue_depth() == 0);
+    assert(engine.get_max_command_queue_depth() >= 1);
+    assert(engine.get_max_command_queue_depth() <=
+           GameEngine::COMMAND_QUEUE_SIZE);
+    assert(engine.get_max_round_trip_latency() >=
+           engine.get_max_command_latency());
+    assert(engine.get_average_round_trip_latency() > 0.);
+  }
+  assert(number_of_notify_calls == 34);
+  assert(card_manager.get_state() == reference.get_state());
+
+  return 0;
+}
@@ -0,0 +1,270 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file testGameLog.cpp
+ *
+ * @brief Unit test for the binary game log writer and reader.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/CardManager.hpp"
+#include "../engine/GameLogReader.hpp"
+#include "../engine/GameLogWriter.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <fstream>
+#include <vector>
+
+/**
+ * @brief Play a game with some rejected sets and record it to the given file.
+ *
+ * @param seed Seed of the game.
+ * @param filename Name of the game log file.
+ * @param checkpoint_interval Number of moves between two checkpoints.
+ * @return State of the game at the end.
+ */
+static GameState record_game(uint64_t seed, std::string filename,
+                             uint16_t checkpoint_interval) {
+  CardManager card_manager(seed);
+  GameLogWriter writer(filename, checkpoint_interval);
+  assert(writer.is_open());
+  card_manager.set_recorder(&writer);
+
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  unsigned int move = 0;
+  while (card_manager.find_all_sets(sets) > 0) {
+    // every other move, we first click and unclick a card, and then click
+    // three cards that do not make up a set
+    if (move % 2 == 0) {
+      card_manager.click_card(0);
+      card_manager.click_card(0);
+      unsigned char no_set = 2;
+      while (no_set < card_manager.get_board().size() &&
+             CardIndex::is_set(card_manager.get_board_indices()[0],
+                               card_manager.get_board_indices()[1],
+                               card_manager.get_board_indices()[no_set])) {
+        ++no_set;
+      }
+      if (no_set < card_manager.get_board().size()) {
+        card_manager.click_card(0);
+        card_manager.click_card(1);
+        card_manager.click_card(no_set);
+      }
+    }
+    card_manager.click_card(sets[0]);
+    card_manager.click_card(sets[1]);
+    card_manager.click_card(sets[2]);
+    ++move;
+  }
+  card_manager.set_recorder(NULL);
+  writer.close();
+  return card_manager.get_state();
+}
+
+/**
+ * @brief Unit test for the binary game log writer and reader.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  // record and replay a number of games, with different checkpoint intervals
+  for (uint64_t seed = 0; seed < 20; ++seed) {
+    const uint16_t checkpoint_interval = 1 + 7 * seed;
+    const GameState final_state =
+        record_game(seed, "test_game_log.bin", checkpoint_interval);
+
+    GameLogReader reader("test_game_log.bin");
+    assert(reader.is_valid());
+    assert(reader.get_header()._seed == seed);
+    assert(reader.get_header()._checkpoint_interval == checkpoint_interval);
+    CardManager card_manager(seed + 1);
+    unsigned long number_of_events;
+    const bool replayed = reader.replay(card_manager, &number_of_events);
+    assert(replayed);
+    assert(number_of_events > 0);
+    assert(card_manager.get_seed() == seed);
+    assert(card_manager.get_state() == final_state);
+  }
+
+  // a log that was started in the middle of a game replays from its first
+  // checkpoint
+  {
+    CardManager card_manager(123);
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    for (unsigned char move = 0; move < 5; ++move) {
+      const unsigned char number_of_sets = card_manager.find_all_sets(sets);
+      assert(number_of_sets > 0);
+      card_manager.click_card(sets[0]);
+      card_manager.click_card(sets[1]);
+      card_manager.click_card(sets[2]);
+    }
+    GameLogWriter writer("test_game_log.bin", 4);
+    card_manager.set_recorder(&writer);
+    // click and unclick a card
+    card_manager.click_card(1);
+    card_manager.click_card(1);
+    // copies of a recorded game are not recorded
+    CardManager copy = card_manager;
+    copy.click_card(0);
+    copy = card_manager;
+    copy.click_card(0);
+    while (card_manager.find_all_sets(sets) > 0) {
+      card_manager.click_card(sets[0]);
+      card_manager.click_card(sets[1]);
+      card_manager.click_card(sets[2]);
+    }
+    card_manager.set_recorder(NULL);
+    writer.close();
+
+    GameLogReader reader("test_game_log.bin");
+    CardManager replay_manager;
+    const bool replayed = reader.replay(replay_manager);
+    assert(replayed);
+    assert(replay_manager.snapshot() == card_manager.snapshot());
+  }
+
+  // tamper with the log: clicking a different card breaks the replay
+  record_game(42, "test_game_log.bin", 16);
+  std::vector<char> log;
+  {
+    std::ifstream file("test_game_log.bin", std::ios::binary);
+    log.assign(std::istreambuf_iterator<char>(file),
+               std::istreambuf_iterator<char>());
+  }
+  // the header is followed by the initial checkpoint, and then by the first
+  // click
+  const size_t first_click = sizeof(GameLogHeader) + sizeof(GameLogEvent) +
+                             sizeof(GameState);
+  assert(log[first_click] == GAMELOGEVENT_CLICK);
+  log[first_click + 1] = (log[first_click + 1] + 1) % 12;
+  {
+    std::ofstream file("test_game_log.bin", std::ios::binary);
+    file.write(log.data(), log.size());
+  }
+  {
+    GameLogReader reader("test_game_log.bin");
+    assert(reader.is_valid());
+    CardManager card_manager;
+    unsigned long number_of_events;
+    const bool replayed = reader.replay(card_manager, &number_of_events);
+    assert(!replayed);
+    assert(number_of_events > 0);
+  }
+
+  // a truncated log cannot be replayed completely
+  {
+    std::ofstream file("test_game_log.bin", std::ios::binary);
+    file.write(log.data(), log.size() - 1);
+  }
+  {
+    GameLogReader reader("test_game_log.bin");
+    assert(reader.is_valid());
+    CardManager card_manager;
+    const bool replayed = reader.replay(card_manager);
+    assert(!replayed);
+  }
+
+  // a log that does not record the extra cards that were dealt after a set
+  // was found cannot be replayed
+  {
+    std::vector<char> deal_log;
+    size_t deal = 0;
+    for (uint64_t seed = 0; deal == 0; ++seed) {
+      record_game(seed, "test_game_log.bin", 1000);
+      std::ifstream file("test_game_log.bin", std::ios::binary);
+      deal_log.assign(std::istreambuf_iterator<char>(file),
+                      std::istreambuf_iterator<char>());
+      size_t position = sizeof(GameLogHeader);
+      while (deal == 0 && position < deal_log.size()) {
+        if (deal_log[position] == GAMELOGEVENT_DEAL) {
+          deal = position;
+        } else if (deal_log[position] == GAMELOGEVENT_CHECKPOINT) {
+          position += sizeof(GameState);
+        }
+        position += sizeof(GameLogEvent);
+      }
+    }
+    deal_log.erase(deal_log.begin() + deal,
+                   deal_log.begin() + deal + sizeof(GameLogEvent));
+    {
+      std::ofstream file("test_game_log.bin", std::ios::binary);
+      file.write(deal_log.data(), deal_log.size());
+    }
+    GameLogReader reader("test_game_log.bin");
+    assert(reader.is_valid());
+    CardManager card_manager;
+    unsigned long number_of_events;
+    const bool replayed = reader.replay(card_manager, &number_of_events);
+    assert(!replayed);
+    assert(number_of_events > 0);
+  }
+
+  // an initial checkpoint that is not a valid game state is rejected before
+  // anything is replayed
+  {
+    record_game(42, "test_game_log.bin", 16);
+    std::vector<char> corrupt_log;
+    {
+      std::ifstream file("test_game_log.bin", std::ios::binary);
+      corrupt_log.assign(std::istreambuf_iterator<char>(file),
+                         std::istreambuf_iterator<char>());
+    }
+    const size_t initial_state = sizeof(GameLogHeader) + sizeof(GameLogEvent);
+    const size_t corruptions[4] = {
+        offsetof(GameState, _main_deck_size), offsetof(GameState, _next_card),
+        offsetof(GameState, _main_deck), offsetof(GameState, _clicked) + 3};
+    for (unsigned char i = 0; i < 4; ++i) {
+      std::vector<char> log_copy = corrupt_log;
+      log_copy[initial_state + corruptions[i]] = char(200);
+      {
+        std::ofstream file("test_game_log.bin", std::ios::binary);
+        file.write(log_copy.data(), log_copy.size());
+      }
+      GameLogReader reader("test_game_log.bin");
+      assert(reader.is_valid());
+      CardManager card_manager;
+      unsigned long number_of_events;
+      const bool replayed = reader.replay(card_manager, &number_of_events);
+      assert(!replayed);
+      assert(number_of_events == 0);
+    }
+  }
+
+  // a file that is not a game log is not valid
+  {
+    std::ofstream file("test_game_log.bin", std::ios::binary);
+    file << "This is not a game log, but it is long enough to contain a "
+            "header. This is not a game log, but it is long enough to "
+            "contain a header.";
+  }
+  {
+    GameLogReader reader("test_game_log.bin");
+    assert(!reader.is_valid());
+  }
+  {
+    GameLogReader reader("this_file_does_not_exist.bin");
+    assert(!reader.is_valid());
+  }
+
+  return 0;
+}
@@ -0,0 +1,263 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testGameServer.cpp
+ *
+ * @brief Unit test for the GameServer class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../network/GameServer.hpp"
+#include "../network/Socket.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * @brief Send a request and wait for the reply.
+ *
+ * @param connection Socket.
+ * @param type GameRequestType.
+ * @param game Index of the game.
+ * @param argument Argument of the request.
+ * @param positions Positions of the claimed cards (claim only).
+ * @return GameReply.
+ */
+static GameReply send_request(int connection, GameRequestType type,
+                              uint32_t game, uint64_t argument = 0,
+                              const unsigned char *positions = NULL) {
+  GameRequest request;
+  std::memset(&request, 0, sizeof(request));
+  request._type = type;
+  request._game = game;
+  request._argument = argument;
+  if (positions != NULL) {
+    std::memcpy(request._positions, positions, 3);
+  }
+  const ssize_t written = write(connection, &request, sizeof(request));
+  assert(written == sizeof(request));
+
+  GameReply reply;
+  size_t size = 0;
+  while (size < sizeof(reply)) {
+    const ssize_t bytes =
+        read(connection, reinterpret_cast<char *>(&reply) + size,
+             sizeof(reply) - size);
+    assert(bytes > 0);
+    size += bytes;
+  }
+  assert(reply._type == type);
+  assert(reply._game == game);
+  return reply;
+}
+
+/**
+ * @brief Check if the board in the given reply matches the given game.
+ *
+ * @param reply GameReply.
+ * @param card_manager CardManager.
+ * @return True if the reply contains the board of the game.
+ */
+static bool is_board(const GameReply &reply,
+                     const CardManager &card_manager) {
+  if (reply._main_deck_size != card_manager.get_board().size() ||
+      reply._next_card != card_manager.get_state()._next_card) {
+    return false;
+  }
+  for (unsigned char i = 0; i < reply._main_deck_size; ++i) {
+    if (reply._main_deck[i] != card_manager.get_board_indices()[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Check that the board in the given reply matches the given game.
+ *
+ * @param reply GameReply.
+ * @param card_manager CardManager.
+ */
+static void check_board(const GameReply &reply,
+                        const CardManager &card_manager) {
+  assert(reply._main_deck_size == card_manager.get_board().size());
+  assert(reply._next_card == card_manager.get_state()._next_card);
+  for (unsigned char i = 0; i < reply._main_deck_size; ++i) {
+    assert(reply._main_deck[i] == card_manager.get_board_indices()[i]);
+  }
+}
+
+/**
+ * @brief Unit test for the GameServer class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  // clients that disappear should not kill the server (see OpenSetServer.cpp)
+  std::signal(SIGPIPE, SIG_IGN);
+
+  // listening on a path that is not a socket does not remove the file
+  {
+    std::ofstream file("test_game_server.txt");
+    file << "not a socket\n";
+  }
+  const int not_a_socket = Socket::listen("./test_game_server.txt");
+  assert(not_a_socket < 0);
+  assert(access("test_game_server.txt", F_OK) == 0);
+  std::remove("test_game_server.txt");
+
+  {
+    GameServer server("./test_game_server.sock", 1000, 42);
+    assert(server.is_listening());
+    std::thread server_thread(&GameServer::run, &server);
+
+    const int player1 = Socket::connect("./test_game_server.sock");
+    const int player2 = Socket::connect("./test_game_server.sock");
+    assert(player1 >= 0);
+    assert(player2 >= 0);
+
+    // all games are dealt with consecutive seeds
+    CardManager reference(42 + 999);
+    GameReply reply = send_request(player1, GAMEREQUEST_BOARD, 999);
+    assert(reply._result == GAMEREPLY_OK);
+    assert(reply._version == 0);
+    check_board(reply, reference);
+    reply = send_request(player1, GAMEREQUEST_BOARD, 1000);
+    assert(reply._result == GAMEREPLY_ERROR);
+
+    // two players claim a set on the same board: only the first one wins
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    const unsigned char number_of_sets = reference.find_all_sets(sets);
+    assert(number_of_sets > 0);
+    reply = send_request(player2, GAMEREQUEST_CLAIM, 999, 0, sets);
+    assert(reply._result == GAMEREPLY_WON);
+    assert(reply._version == 1);
+    reference.click_card(sets[0]);
+    reference.click_card(sets[1]);
+    reference.click_card(sets[2]);
+    check_board(reply, reference);
+    reply = send_request(player1, GAMEREQUEST_CLAIM, 999, 0, sets);
+    assert(reply._result == GAMEREPLY_STALE);
+    check_board(reply, reference);
+
+    // claims on the current version are checked
+    const unsigned char no_set[3] = {0, 0, 1};
+    reply = send_request(player1, GAMEREQUEST_CLAIM, 999, 1, no_set);
+    assert(reply._result == GAMEREPLY_INVALID);
+    assert(reply._version == 1);
+
+    // play the rest of the game
+    while (reference.find_all_sets(sets) > 0) {
+      reply =
+          send_request(player1, GAMEREQUEST_CLAIM, 999, reply._version, sets);
+      assert(reply._result == GAMEREPLY_WON);
+      reference.click_card(sets[0]);
+      reference.click_card(sets[1]);
+      reference.click_card(sets[2]);
+      check_board(reply, reference);
+    }
+
+    // deal a new game at the same table
+    reply = send_request(player2, GAMEREQUEST_DEAL, 999, 7);
+    assert(reply._result == GAMEREPLY_OK);
+    check_board(reply, CardManager(7));
+
+    // a client that pipelines many requests before reading any replies is
+    // throttled instead of making the server queue all replies
+    const uint32_t number_of_requests = 20000;
+    std::thread writer([player1, number_of_requests]() {
+      std::vector<GameRequest> requests(number_of_requests);
+      std::memset(requests.data(), 0, requests.size() * sizeof(GameRequest));
+      for (uint32_t i = 0; i < number_of_requests; ++i) {
+        requests[i]._type = GAMEREQUEST_BOARD;
+        requests[i]._game = i % 1000;
+      }
+      const char *data = reinterpret_cast<const char *>(requests.data());
+      size_t size = 0;
+      while (size < requests.size() * sizeof(GameRequest)) {
+        const ssize_t bytes =
+            write(player1, data + size,
+                  requests.size() * sizeof(GameRequest) - size);
+        assert(bytes > 0);
+        size += bytes;
+      }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (uint32_t i = 0; i < number_of_requests; ++i) {
+      size_t size = 0;
+      while (size < sizeof(reply)) {
+        const ssize_t bytes =
+            read(player1, reinterpret_cast<char *>(&reply) + size,
+                 sizeof(reply) - size);
+        assert(bytes > 0);
+        size += bytes;
+      }
+      assert(reply._type == GAMEREQUEST_BOARD);
+      assert(reply._game == i % 1000);
+    }
+    writer.join();
+    // the server reads at most 4096 bytes of requests at a time
+    assert(server.get_maximum_output_size() <
+           GameServer::MAX_OUTPUT_SIZE +
+               (4096 / sizeof(GameRequest)) *
+                   sizeof(GameReply));
+
+    // requests that were sent before hanging up are still handled
+    const int player3 = Socket::connect("./test_game_server.sock");
+    assert(player3 >= 0);
+    GameRequest deal;
+    std::memset(&deal, 0, sizeof(deal));
+    deal._type = GAMEREQUEST_DEAL;
+    deal._game = 998;
+    deal._argument = 5;
+    const ssize_t written = write(player3, &deal, sizeof(deal));
+    assert(written == sizeof(deal));
+    close(player3);
+    const CardManager dealt(5);
+    reply = send_request(player2, GAMEREQUEST_BOARD, 998);
+    for (unsigned int i = 0; i < 100 && !is_board(reply, dealt); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      reply = send_request(player2, GAMEREQUEST_BOARD, 998);
+    }
+    check_board(reply, dealt);
+
+    close(player1);
+    close(player2);
+    server.stop();
+    server_thread.join();
+
+    assert(server.get_number_of_requests(GAMEREQUEST_DEAL) == 2);
+    assert(server.get_number_of_replies(GAMEREPLY_STALE) == 1);
+    assert(server.get_number_of_replies(GAMEREPLY_INVALID) == 1);
+    assert(server.get_number_of_replies(GAMEREPLY_ERROR) == 1);
+  }
+  // the server removes its socket file when it is destroyed
+  assert(access("test_game_server.sock", F_OK) < 0);
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file testRandomGenerator.cpp
+ *
+ * @brief Unit test for the RandomGenerator class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/RandomGenerator.hpp"
+
+#include <cassert>
+#include <cmath>
+
+/**
+ * @brief Unit test for the RandomGenerator class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+
+  // the same seed gives the same sequence, different seeds do not
+  {
+    RandomGenerator generator1(42);
+    RandomGenerator generator2(42);
+    RandomGenerator generator3(43);
+    bool same_sequence = true;
+    for (unsigned int i = 0; i < 100; ++i) {
+      const uint32_t value = generator1.get_random_integer();
+      const uint32_t same_seed_value = generator2.get_random_integer();
+      assert(value == same_seed_value);
+      same_sequence &= (value == generator3.get_random_integer());
+    }
+    assert(!same_sequence);
+  }
+
+  // bounded integers are within bounds and (roughly) uniform
+  {
+    RandomGenerator generator(1);
+    unsigned int counts[6] = {0, 0, 0, 0, 0, 0};
+    const unsigned int number_of_samples = 600000;
+    for (unsigned int i = 0; i < number_of_samples; ++i) {
+      const uint32_t value = generator.get_random_integer(6);
+      assert(value < 6);
+      ++counts[value];
+    }
+    // the expected standard deviation of every count is ~300
+    for (unsigned int i = 0; i < 6; ++i) {
+      assert(std::abs(static_cast<int>(counts[i]) - 100000) < 2000);
+    }
+  }
+
+  // shuffling produces a permutation, and every element ends up in every
+  // position with (roughly) equal probability
+  {
+    RandomGenerator generator(2);
+    unsigned int position_counts[4][4] = {};
+    for (unsigned int i = 0; i < 40000; ++i) {
+      unsigned char array[4] = {0, 1, 2, 3};
+      generator.shuffle(array, 4);
+      unsigned char seen = 0;
+      for (unsigned int j = 0; j < 4; ++j) {
+        seen |= 1 << array[j];
+        ++position_counts[array[j]][j];
+      }
+      assert(seen == 15);
+    }
+    for (unsigned int j = 0; j < 4; ++j) {
+      for (unsigned int k = 0; k < 4; ++k) {
+        assert(std::abs(static_cast<int>(position_counts[j][k]) - 10000) <
+               500);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testSPSCQueue.cpp
+ *
+ * @brief Unit test for the SPSCQueue class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/SPSCQueue.hpp"
+
+#include <cassert>
+#include <thread>
+
+/**
+ * @brief Unit test for the SPSCQueue class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+
+  // single thread: first in, first out, and the capacity is respected
+  {
+    SPSCQueue<unsigned int, 4> queue;
+    unsigned int element;
+    assert(queue.empty());
+    bool popped = queue.try_pop(element);
+    assert(!popped);
+    bool pushed;
+    for (unsigned int i = 0; i < 4; ++i) {
+      pushed = queue.try_push(i);
+      assert(pushed);
+    }
+    pushed = queue.try_push(4);
+    assert(!pushed);
+    assert(queue.size() == 4);
+    assert(queue.get_max_size() == 4);
+    for (unsigned int i = 0; i < 4; ++i) {
+      popped = queue.try_pop(element);
+      assert(popped);
+      assert(element == i);
+    }
+    assert(queue.empty());
+
+    // wrap around the end of the buffer
+    for (unsigned int i = 0; i < 10; ++i) {
+      pushed = queue.try_push(i);
+      assert(pushed);
+      popped = queue.try_pop(element);
+      assert(popped);
+      assert(element == i);
+    }
+    assert(queue.get_max_size() == 4);
+  }
+
+  // two threads: all elements arrive, in order
+  {
+    const unsigned int number_of_elements = 1000000;
+    SPSCQueue<unsigned int, 64> queue;
+    std::thread producer([&queue, number_of_elements]() {
+      for (unsigned int i = 0; i < number_of_elements; ++i) {
+        while (!queue.try_push(i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    unsigned int expected = 0;
+    while (expected < number_of_elements) {
+      unsigned int element;
+      if (queue.try_pop(element)) {
+        assert(element == expected);
+        ++expected;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    producer.join();
+    assert(queue.empty());
+    assert(queue.get_max_size() <= queue.get_capacity());
+  }
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file testSetRules.cpp
+ *
+ * @brief Unit test for the generic SetRules class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/CardIndex.hpp"
+#include "../engine/SetRules.hpp"
+
+#include <cassert>
+#include <vector>
+
+/**
+ * @brief Check the set rules for a deck with the given number of attributes.
+ *
+ * The third card table is checked against the explicit rule (every attribute
+ * is either the same for all three cards or different for all three cards),
+ * and the full deck should contain exactly @f$3^N(3^N-1)/6@f$ sets, since
+ * every pair of cards belongs to exactly one set.
+ */
+template <unsigned char _number_of_attributes_> static void check_rules() {
+  typedef SetRules<_number_of_attributes_> Rules;
+  const unsigned int number_of_cards = Rules::CARD_COUNTER;
+  assert(number_of_cards == get_number_of_cards(_number_of_attributes_));
+
+  for (unsigned int card1 = 0; card1 < number_of_cards; ++card1) {
+    // the encoding is a bijection between attribute values and indices
+    unsigned char values[_number_of_attributes_];
+    for (unsigned char attribute = 0; attribute < _number_of_attributes_;
+         ++attribute) {
+      values[attribute] = Rules::get_value(card1, attribute);
+      assert(values[attribute] < Rules::NUMBER_OF_VALUES);
+    }
+    assert(Rules::get_index(values) == card1);
+
+    for (unsigned int card2 = 0; card2 < number_of_cards; ++card2) {
+      const unsigned char third_card = Rules::get_third_card(card1, card2);
+      assert(third_card < number_of_cards);
+      assert(Rules::is_set(card1, card2, third_card));
+      assert(Rules::is_set(card2, third_card, card1));
+      for (unsigned char attribute = 0; attribute < _number_of_attributes_;
+           ++attribute) {
+        const unsigned char a = Rules::get_value(card1, attribute);
+        const unsigned char b = Rules::get_value(card2, attribute);
+        const unsigned char c = Rules::get_value(third_card, attribute);
+        assert((a == b && b == c) || (a != b && b != c && a != c));
+      }
+    }
+  }
+
+  // the full deck: every pair of cards belongs to exactly one set
+  std::vector<unsigned char> deck(number_of_cards);
+  for (unsigned int card = 0; card < number_of_cards; ++card) {
+    deck[card] = card;
+  }
+  const unsigned int number_of_sets =
+      number_of_cards * (number_of_cards - 1) / 6;
+  std::vector<unsigned char> sets(3 * number_of_sets);
+  const unsigned int number_of_found_sets =
+      Rules::find_all_sets(deck.data(), number_of_cards, sets.data());
+  assert(number_of_found_sets == number_of_sets);
+  assert(Rules::count_sets(deck.data(), number_of_cards) == number_of_sets);
+  assert(Rules::has_set(deck.data(), number_of_cards));
+  for (unsigned int set = 0; set < number_of_sets; ++set) {
+    assert(sets[3 * set] < sets[3 * set + 1]);
+    assert(sets[3 * set + 1] < sets[3 * set + 2]);
+    assert(Rules::is_set(deck[sets[3 * set]], deck[sets[3 * set + 1]],
+                         deck[sets[3 * set + 2]]));
+  }
+
+  // two cards never make up a set on their own
+  assert(!Rules::has_set(deck.data(), 2));
+}
+
+/**
+ * @brief Unit test for the generic SetRules class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  check_rules<1>();
+  check_rules<2>();
+  check_rules<3>();
+  check_rules<4>();
+  check_rules<5>();
+
+  // the classic game uses the 4 attribute rules
+  for (unsigned char card1 = 0; card1 < CardIndex::CARDINDEX_COUNTER;
+       ++card1) {
+    for (unsigned char card2 = 0; card2 < CardIndex::CARDINDEX_COUNTER;
+         ++card2) {
+      assert(CardIndex::get_third_card(card1, card2) ==
+             SetRules<4>::get_third_card(card1, card2));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testSharedGame.cpp
+ *
+ * @brief Unit test for the SharedGame class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/SharedGame.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Player thread: keeps claiming the first set on the board until the
+ * game is finished.
+ *
+ * Every player starts looking at a different set, so that players regularly
+ * claim different sets on the same board version.
+ *
+ * @param game SharedGame.
+ * @param player Index of the player.
+ * @param won Number of claims this player won.
+ * @param stale Number of claims this player lost.
+ */
+static void play(SharedGame &game, unsigned int player, unsigned long &won,
+                 unsigned long &stale) {
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  while (true) {
+    const SharedBoard board = game.read();
+    const unsigned char number_of_sets = CardManager::find_all_sets(
+        board._main_deck, board._main_deck_size, sets);
+    assert(number_of_sets == board._set_count);
+    if (number_of_sets == 0) {
+      return;
+    }
+    const SharedGameClaimResult result =
+        game.claim(board, sets + 3 * (player % number_of_sets));
+    assert(result != SHAREDGAMECLAIM_INVALID);
+    if (result == SHAREDGAMECLAIM_WON) {
+      ++won;
+    } else {
+      ++stale;
+    }
+  }
+}
+
+/**
+ * @brief Unit test for the SharedGame class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+
+  // single player: the shared game behaves like a normal game
+  {
+    SharedGame game(42);
+    CardManager reference(42);
+    SharedBoard board = game.read();
+    assert(board._version == 0);
+    assert(board._main_deck_size == reference.get_board().size());
+    for (unsigned char i = 0; i < board._main_deck_size; ++i) {
+      assert(board._main_deck[i] == reference.get_board_indices()[i]);
+    }
+
+    unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+    const unsigned char number_of_sets = reference.find_all_sets(sets);
+    assert(number_of_sets == board._set_count);
+
+    // invalid claims do not change the board
+    const unsigned char same_card[3] = {sets[0], sets[0], sets[1]};
+    SharedGameClaimResult result = game.claim(board, same_card);
+    assert(result == SHAREDGAMECLAIM_INVALID);
+    const unsigned char off_board[3] = {sets[0], sets[1],
+                                        CardManager::MAX_BOARD_SIZE};
+    result = game.claim(board, off_board);
+    assert(result == SHAREDGAMECLAIM_INVALID);
+    unsigned char no_set[3] = {sets[0], sets[1], 0};
+    while (CardIndex::is_set(board._main_deck[no_set[0]],
+                             board._main_deck[no_set[1]],
+                             board._main_deck[no_set[2]]) ||
+           no_set[2] == no_set[0] || no_set[2] == no_set[1]) {
+      ++no_set[2];
+    }
+    result = game.claim(board, no_set);
+    assert(result == SHAREDGAMECLAIM_INVALID);
+    assert(game.get_version() == 0);
+
+    // a valid claim wins exactly once
+    result = game.claim(board, sets);
+    assert(result == SHAREDGAMECLAIM_WON);
+    result = game.claim(board, sets);
+    assert(result == SHAREDGAMECLAIM_STALE);
+    assert(game.get_version() == 2);
+    reference.click_card(sets[0]);
+    reference.click_card(sets[1]);
+    reference.click_card(sets[2]);
+
+    // the rest of the game
+    while (true) {
+      board = game.read();
+      for (unsigned char i = 0; i < board._main_deck_size; ++i) {
+        assert(board._main_deck[i] == reference.get_board_indices()[i]);
+      }
+      assert(board._set_count == reference.set_count());
+      if (reference.find_all_sets(sets) == 0) {
+        break;
+      }
+      result = game.claim(board, sets);
+      assert(result == SHAREDGAMECLAIM_WON);
+      reference.click_card(sets[0]);
+      reference.click_card(sets[1]);
+      reference.click_card(sets[2]);
+    }
+  }
+
+  // many players racing for the same sets: every set is taken exactly once
+  {
+    const unsigned int number_of_players = 32;
+    for (uint64_t seed = 1; seed <= 20; ++seed) {
+      SharedGame game(seed);
+      std::vector<unsigned long> won(number_of_players, 0);
+      std::vector<unsigned long> stale(number_of_players, 0);
+      std::vector<std::thread> players;
+      for (unsigned int i = 0; i < number_of_players; ++i) {
+        players.push_back(std::thread(play, std::ref(game), i,
+                                      std::ref(won[i]), std::ref(stale[i])));
+      }
+      for (unsigned int i = 0; i < number_of_players; ++i) {
+        players[i].join();
+      }
+
+      unsigned long total_won = 0;
+      for (unsigned int i = 0; i < number_of_players; ++i) {
+        total_won += won[i];
+      }
+      const SharedBoard board = game.read();
+      assert(board._set_count == 0);
+      assert(game.get_version() == 2 * total_won);
+      assert(3 * total_won + board._main_deck_size == board._next_card);
+    }
+  }
+
+  return 0;
+}
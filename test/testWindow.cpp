@@ -27,6 +27,8 @@
 #include "../engine/CardManager.hpp"
 #include "../visuals/Window.hpp"
 
+#include <cassert>
+
 /**
  * @brief Unit test for the Window class.
  *
@@ -40,5 +42,14 @@ int main(int argc, char **argv) {
 
   window.show(false);
 
+  // process the pending expose events: every card is drawn at least once
+  while (gtk_events_pending()) {
+    gtk_main_iteration();
+  }
+
+  // fill patterns are shared: there are at most 9 different ones
+  assert(window.get_total_pattern_allocations() <=
+         CardProperties::CARDCOLOUR_COUNTER * CardProperties::CARDFILL_COUNTER);
+
   return 0;
 }
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/**
+ * @file testWorkStealingPool.cpp
+ *
+ * @brief Unit test for the WorkStealingPool class.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "../engine/CardManager.hpp"
+#include "../parallel/WorkStealingPool.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Play a complete game, taking the first set that is found every time.
+ *
+ * @param seed Seed of the game.
+ * @return Number of sets that was taken.
+ */
+static unsigned char play_game(uint64_t seed) {
+  CardManager card_manager(seed);
+  unsigned char number_of_sets = 0;
+  unsigned char sets[3 * CardManager::MAX_NUMBER_OF_SETS];
+  while (card_manager.find_all_sets(sets) > 0) {
+    card_manager.click_card(sets[0]);
+    card_manager.click_card(sets[1]);
+    card_manager.click_card(sets[2]);
+    ++number_of_sets;
+  }
+  return number_of_sets;
+}
+
+/**
+ * @brief Unit test for the WorkStealingPool class.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return Exit code: 0 on success.
+ */
+int main(int argc, char **argv) {
+  const unsigned int number_of_workers = 4;
+  WorkStealingPool pool(number_of_workers);
+  assert(pool.get_number_of_workers() == number_of_workers);
+
+  // a batch of games: every game is played exactly once, by some worker, and
+  // gives the same result as playing it on the main thread
+  {
+    const unsigned long number_of_games = 1000;
+    std::vector<unsigned char> game_lengths(number_of_games, 0);
+    std::vector<std::atomic<unsigned int>> number_of_calls(number_of_games);
+    for (unsigned long i = 0; i < number_of_games; ++i) {
+      number_of_calls[i] = 0;
+    }
+    pool.reset_statistics();
+    pool.run_batch(number_of_games, [&game_lengths, &number_of_calls,
+                                     number_of_workers](unsigned long game,
+                                                        unsigned int worker) {
+      assert(worker < number_of_workers);
+      ++number_of_calls[game];
+      game_lengths[game] = play_game(game);
+    });
+    unsigned long number_of_tasks = 0;
+    for (unsigned int i = 0; i < number_of_workers; ++i) {
+      number_of_tasks += pool.get_number_of_tasks(i);
+      assert(pool.get_utilization(i) >= 0.);
+      assert(pool.get_utilization(i) <= 1.);
+    }
+    // the batch is executed in chunks of contiguous games
+    assert(number_of_tasks >= number_of_workers);
+    assert(number_of_tasks <=
+           2 * number_of_workers * WorkStealingPool::CHUNKS_PER_WORKER);
+    for (unsigned long i = 0; i < number_of_games; ++i) {
+      assert(number_of_calls[i] == 1);
+      assert(game_lengths[i] == play_game(i));
+    }
+  }
+
+  // a single task that spawns many slow tasks on its own deque: the other
+  // workers can only help by stealing
+  {
+    const unsigned int number_of_subtasks = 200;
+    std::atomic<unsigned int> number_of_finished_subtasks(0);
+    pool.reset_statistics();
+    pool.submit([&pool, &number_of_finished_subtasks,
+                 number_of_subtasks](unsigned int) {
+      for (unsigned int i = 0; i < number_of_subtasks; ++i) {
+        pool.submit([&number_of_finished_subtasks](unsigned int) {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+          ++number_of_finished_subtasks;
+        });
+      }
+    });
+    pool.wait();
+    assert(number_of_finished_subtasks == number_of_subtasks);
+    unsigned long number_of_tasks = 0;
+    unsigned long number_of_steals = 0;
+    for (unsigned int i = 0; i < number_of_workers; ++i) {
+      number_of_tasks += pool.get_number_of_tasks(i);
+      number_of_steals += pool.get_number_of_steals(i);
+    }
+    assert(number_of_tasks == number_of_subtasks + 1);
+    assert(number_of_steals > 0);
+  }
+
+  // waiting for an idle pool returns immediately
+  pool.wait();
+
+  return 0;
+}
@@ -0,0 +1,486 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file CardRenderer.cpp
+ *
+ * @brief CardRenderer implementation.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#include "CardRenderer.hpp"
+#include "../engine/Card.hpp"
+#include "../engine/CardIndex.hpp"
+
+#include <cmath>
+
+/**
+ * @brief Constructor.
+ */
+CardRenderer::CardRenderer()
+    : _fill_patterns{}, _symbol_paths{}, _symbol_path_width(0),
+      _frame_surface_allocations(0), _frame_pattern_allocations(0),
+      _frame_shapes_drawn(0), _frame_shapes_skipped(0),
+      _total_surface_allocations(0), _total_pattern_allocations(0),
+      _total_path_allocations(0) {}
+
+/**
+ * @brief Destructor.
+ *
+ * Frees the fill pattern and symbol outline caches.
+ */
+CardRenderer::~CardRenderer() {
+  clear_fill_patterns();
+  clear_symbol_paths();
+}
+
+/**
+ * @brief Start a new frame: reset the per frame allocation and drawing
+ * counters.
+ */
+void CardRenderer::start_frame() {
+  _frame_surface_allocations = 0;
+  _frame_pattern_allocations = 0;
+  _frame_shapes_drawn = 0;
+  _frame_shapes_skipped = 0;
+}
+
+/**
+ * @brief Get the number of cairo surfaces that were allocated since the
+ * start of the last frame.
+ *
+ * @return Number of surface allocations during the last frame.
+ */
+unsigned int CardRenderer::get_frame_surface_allocations() const {
+  return _frame_surface_allocations;
+}
+
+/**
+ * @brief Get the number of cairo patterns that were allocated since the
+ * start of the last frame.
+ *
+ * @return Number of pattern allocations during the last frame.
+ */
+unsigned int CardRenderer::get_frame_pattern_allocations() const {
+  return _frame_pattern_allocations;
+}
+
+/**
+ * @brief Get the number of symbols that were drawn since the start of the
+ * last frame.
+ *
+ * @return Number of symbols drawn during the last frame.
+ */
+unsigned int CardRenderer::get_frame_shapes_drawn() const {
+  return _frame_shapes_drawn;
+}
+
+/**
+ * @brief Get the number of symbols that were skipped since the start of the
+ * last frame, because they were completely outside the clip region.
+ *
+ * @return Number of symbols skipped during the last frame.
+ */
+unsigned int CardRenderer::get_frame_shapes_skipped() const {
+  return _frame_shapes_skipped;
+}
+
+/**
+ * @brief Get the total number of cairo surfaces that were allocated.
+ *
+ * @return Total number of surface allocations.
+ */
+unsigned long CardRenderer::get_total_surface_allocations() const {
+  return _total_surface_allocations;
+}
+
+/**
+ * @brief Get the total number of cairo patterns that were allocated.
+ *
+ * @return Total number of pattern allocations.
+ */
+unsigned long CardRenderer::get_total_pattern_allocations() const {
+  return _total_pattern_allocations;
+}
+
+/**
+ * @brief Get the total number of cairo paths that were allocated.
+ *
+ * @return Total number of path allocations.
+ */
+unsigned long CardRenderer::get_total_path_allocations() const {
+  return _total_path_allocations;
+}
+
+/**
+ * @brief Draw a rectangle with rounded edges.
+ *
+ * @param cr cairo_t instance to use for drawing.
+ * @param origin_x Upper left corner of the rectangle: horizontal position.
+ * @param origin_y Upper left corner of the rectangle: vertical position.
+ * @param side_x Width: horizontal size of the rectangle.
+ * @param side_y Height: vertical size of the rectangle.
+ * @param r Radius used for round corners.
+ */
+void CardRenderer::draw_rounded_rectangle(cairo_t *cr, double origin_x,
+                                          double origin_y, double side_x,
+                                          double side_y, double r) {
+
+  cairo_new_sub_path(cr);
+  cairo_arc(cr, origin_x + side_x - r, origin_y + r, r, -0.5 * M_PI, 0.);
+  cairo_arc(cr, origin_x + side_x - r, origin_y + side_y - r, r, 0.,
+            0.5 * M_PI);
+  cairo_arc(cr, origin_x + r, origin_y + side_y - r, r, 0.5 * M_PI, M_PI);
+  cairo_arc(cr, origin_x + r, origin_y + r, r, M_PI, 1.5 * M_PI);
+  cairo_close_path(cr);
+}
+
+/**
+ * @brief Draw an oval.
+ *
+ * @param cr cairo_t instance to use for drawing.
+ * @param origin Coordinates of the center of the oval.
+ * @param size Side lenghts of the oval.
+ */
+void CardRenderer::draw_oval(cairo_t *cr, double origin[2],
+                             double size[2]) {
+  draw_rounded_rectangle(cr, origin[0] - 0.5 * size[0],
+                         origin[1] - 0.5 * size[1], size[0], size[1],
+                         0.5 * size[1]);
+}
+
+/**
+ * @brief Draw a rhombus.
+ *
+ * @param cr cairo_t instance to use for drawing.
+ * @param origin Coordinates of the center of the rhombus.
+ * @param size Side lengths of the rhombus.
+ */
+void CardRenderer::draw_rhombus(cairo_t *cr, double origin[2],
+                                double size[2]) {
+  cairo_new_sub_path(cr);
+  cairo_move_to(cr, origin[0] - 0.5 * size[0], origin[1]);
+  cairo_line_to(cr, origin[0], origin[1] - 0.5 * size[1]);
+  cairo_line_to(cr, origin[0] + 0.5 * size[0], origin[1]);
+  cairo_line_to(cr, origin[0], origin[1] + 0.5 * size[1]);
+  cairo_line_to(cr, origin[0] - 0.5 * size[0], origin[1]);
+  cairo_close_path(cr);
+}
+
+/**
+ * @brief Draw a wiggly shape.
+ *
+ * @param cr cairo_t instance to use for drawing.
+ * @param origin Coordinates of the center of the wiggly shape.
+ * @param size Side lenghts of the wiggly shape.
+ */
+void CardRenderer::draw_wiggle(cairo_t *cr, double origin[2],
+                               double size[2]) {
+  cairo_new_sub_path(cr);
+  cairo_move_to(cr, origin[0] - 0.5 * size[0], origin[1]);
+  cairo_curve_to(cr, origin[0] - 0.5 * size[0], origin[1] - 0.25 * size[1],
+                 origin[0] - 0.25 * size[0], origin[1] - 0.5 * size[1],
+                 origin[0], origin[1] - 0.25 * size[1]);
+  cairo_curve_to(cr, origin[0] + 0.25 * size[0], origin[1],
+                 origin[0] + 0.5 * size[0], origin[1] - 1. * size[1],
+                 origin[0] + 0.5 * size[0], origin[1]);
+  cairo_curve_to(cr, origin[0] + 0.5 * size[0], origin[1] + 0.25 * size[1],
+                 origin[0] + 0.25 * size[0], origin[1] + 0.5 * size[1],
+                 origin[0], origin[1] + 0.25 * size[1]);
+  cairo_curve_to(cr, origin[0] - 0.25 * size[0], origin[1],
+                 origin[0] - 0.5 * size[0], origin[1] + 1. * size[1],
+                 origin[0] - 0.5 * size[0], origin[1]);
+  cairo_close_path(cr);
+}
+
+/**
+ * @brief Draw the given shape.
+ *
+ * @param cr cairo_t instance to use for drawing.
+ * @param shape CardSymbol to draw.
+ * @param origin Coordinates of the center of the shape.
+ * @param size Side lengths of the shape.
+ */
+void CardRenderer::draw_shape(cairo_t *cr,
+                              CardProperties::CardSymbol shape,
+                              double origin[2], double size[2]) {
+  switch (shape) {
+  case CardProperties::CARDSYMBOL_OVAL:
+    draw_oval(cr, origin, size);
+    break;
+  case CardProperties::CARDSYMBOL_RHOMBUS:
+    draw_rhombus(cr, origin, size);
+    break;
+  case CardProperties::CARDSYMBOL_WIGGLE:
+    draw_wiggle(cr, origin, size);
+    break;
+  }
+}
+
+/**
+ * @brief Set the drawing colour.
+ *
+ * @param cr cairo_t instance that will be affected.
+ * @param colour CardColour to set.
+ */
+void CardRenderer::set_drawing_colour(cairo_t *cr,
+                                      CardProperties::CardColour colour) {
+  switch (colour) {
+  case CardProperties::CARDCOLOUR_RED:
+    cairo_set_source_rgb(cr, 1, 0, 0);
+    break;
+  case CardProperties::CARDCOLOUR_BLUE:
+    cairo_set_source_rgb(cr, 0, 1, 0);
+    break;
+  case CardProperties::CARDCOLOUR_GREEN:
+    cairo_set_source_rgb(cr, 0, 0, 1);
+    break;
+  }
+}
+
+/**
+ * @brief Get the fill pattern for the given colour and fill type.
+ *
+ * There are only 9 different fill patterns, which are created once and then
+ * shared by all cards.
+ *
+ * @param colour CardColour.
+ * @param fill CardFill.
+ * @return Fill pattern. The pattern is owned by the cache and should not be
+ * destroyed.
+ */
+cairo_pattern_t *
+CardRenderer::get_fill_pattern(CardProperties::CardColour colour,
+                               CardProperties::CardFill fill) {
+  cairo_pattern_t *&pattern = _fill_patterns[colour][fill];
+  if (pattern == NULL) {
+    const int fill_type = 2 - static_cast<int>(fill);
+
+    cairo_surface_t *texture =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 10, 10);
+    ++_frame_surface_allocations;
+    ++_total_surface_allocations;
+    cairo_t *tcr = cairo_create(texture);
+    set_drawing_colour(tcr, colour);
+    cairo_rectangle(tcr, fill_type * 5, 0, 10, 10);
+    cairo_fill(tcr);
+    cairo_destroy(tcr);
+
+    pattern = cairo_pattern_create_for_surface(texture);
+    ++_frame_pattern_allocations;
+    ++_total_pattern_allocations;
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+    // the pattern keeps its own reference to the texture
+    cairo_surface_destroy(texture);
+  }
+  return pattern;
+}
+
+/**
+ * @brief Clear the fill pattern cache.
+ */
+void CardRenderer::clear_fill_patterns() {
+  for (unsigned char colour = 0; colour < CardProperties::CARDCOLOUR_COUNTER;
+       ++colour) {
+    for (unsigned char fill = 0; fill < CardProperties::CARDFILL_COUNTER;
+         ++fill) {
+      if (_fill_patterns[colour][fill] != NULL) {
+        cairo_pattern_destroy(_fill_patterns[colour][fill]);
+        _fill_patterns[colour][fill] = NULL;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Get the outline of the given symbol, centered on the origin.
+ *
+ * The outlines only depend on the symbol type and the card width, and are
+ * created once and then reused for every card with the same width. When the
+ * card width changes, all cached outlines are recreated.
+ *
+ * @param cr cairo_t instance used to create the outline (its current path is
+ * cleared).
+ * @param shape CardSymbol.
+ * @param width Width of the card (in pixels).
+ * @param size Side lengths of the symbol.
+ * @return Outline of the symbol (owned by the renderer).
+ */
+const cairo_path_t *
+CardRenderer::get_symbol_path(cairo_t *cr, CardProperties::CardSymbol shape,
+                              int width, double size[2]) {
+  if (width != _symbol_path_width) {
+    clear_symbol_paths();
+    _symbol_path_width = width;
+  }
+  if (_symbol_paths[shape] == NULL) {
+    double origin[2] = {0., 0.};
+    cairo_new_path(cr);
+    draw_shape(cr, shape, origin, size);
+    _symbol_paths[shape] = cairo_copy_path(cr);
+    cairo_new_path(cr);
+    ++_total_path_allocations;
+  }
+  return _symbol_paths[shape];
+}
+
+/**
+ * @brief Free all cached symbol outlines.
+ */
+void CardRenderer::clear_symbol_paths() {
+  for (unsigned char shape = 0; shape < CardProperties::CARDSYMBOL_COUNTER;
+       ++shape) {
+    if (_symbol_paths[shape] != NULL) {
+      cairo_path_destroy(_symbol_paths[shape]);
+      _symbol_paths[shape] = NULL;
+    }
+  }
+}
+
+/**
+ * @brief Draw the face of the given card.
+ *
+ * Only the symbols that overlap with the current clip region of the given
+ * cairo context are drawn.
+ *
+ * @param cr cairo_t instance to use for drawing.
+ * @param card Card to draw.
+ * @param clicked Is the card clicked?
+ * @param width Width of the card (in pixels).
+ * @param height Height of the card (in pixels).
+ */
+void CardRenderer::draw_card(cairo_t *cr, const Card &card, bool clicked,
+                             int width, int height) {
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  draw_rounded_rectangle(cr, 0, 0, width, height, 20.);
+  cairo_fill(cr);
+
+  if (clicked) {
+    cairo_set_source_rgb(cr, 1, 0, 0);
+    draw_rounded_rectangle(cr, 0, 0, width, height, 20.);
+    cairo_stroke(cr);
+  }
+
+  double shape_size[2];
+  shape_size[0] = 0.5 * width;
+  shape_size[1] = 0.5 * shape_size[0];
+
+  double shape_origin[2];
+  shape_origin[0] = 0.5 * width;
+
+  int num_shape = card.get_number_of_symbols();
+  CardProperties::CardSymbol shape_type = card.get_symbol();
+  CardProperties::CardColour colour_type = card.get_colour();
+  cairo_pattern_t *pattern = get_fill_pattern(colour_type, card.get_fill());
+
+  // symbols that do not overlap with the clip region are not drawn. The
+  // bounding box of a symbol is enlarged with half the line width to account
+  // for the stroke, and the wiggle control points reach up to a full symbol
+  // height away from the symbol center
+  double clip_x1, clip_y1, clip_x2, clip_y2;
+  cairo_clip_extents(cr, &clip_x1, &clip_y1, &clip_x2, &clip_y2);
+  const double margin = 0.5 * cairo_get_line_width(cr);
+  const double half_width = 0.5 * shape_size[0] + margin;
+  const double half_height = shape_size[1] + margin;
+  if (shape_origin[0] + half_width < clip_x1 ||
+      shape_origin[0] - half_width > clip_x2) {
+    _frame_shapes_skipped += num_shape;
+    return;
+  }
+
+  const cairo_path_t *path =
+      get_symbol_path(cr, shape_type, width, shape_size);
+
+  double shape_spacing = height / (num_shape + 1.);
+  for (int i = 0; i < num_shape; ++i) {
+    shape_origin[1] = (i + 1) * shape_spacing;
+
+    if (shape_origin[1] + half_height < clip_y1 ||
+        shape_origin[1] - half_height > clip_y2) {
+      ++_frame_shapes_skipped;
+      continue;
+    }
+    ++_frame_shapes_drawn;
+
+    // the cached outline is centered on the origin: move it into place
+    cairo_save(cr);
+    cairo_translate(cr, shape_origin[0], shape_origin[1]);
+    cairo_append_path(cr, path);
+    cairo_restore(cr);
+    cairo_set_source(cr, pattern);
+    cairo_fill_preserve(cr);
+    set_drawing_colour(cr, colour_type);
+    cairo_stroke(cr);
+  }
+}
+
+/**
+ * @brief Render the given card into a new image surface.
+ *
+ * @param card Card to draw.
+ * @param clicked Is the card clicked?
+ * @param width Width of the card (in pixels).
+ * @param height Height of the card (in pixels).
+ * @return New ARGB32 image surface containing the card. The caller is
+ * responsible for destroying the surface.
+ */
+cairo_surface_t *CardRenderer::create_card_surface(const Card &card,
+                                                   bool clicked, int width,
+                                                   int height) {
+  cairo_surface_t *surface =
+      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+  ++_frame_surface_allocations;
+  ++_total_surface_allocations;
+  cairo_t *cr = cairo_create(surface);
+  draw_card(cr, card, clicked, width, height);
+  cairo_destroy(cr);
+  return surface;
+}
+
+/**
+ * @brief Render all cards to a single sprite sheet and write it to a PNG file.
+ *
+ * The sprite sheet contains 9 rows of 9 cards, in card index order (see
+ * CardIndex.hpp).
+ *
+ * @param filename Name of the PNG file to write.
+ * @param card_width Width of a single card (in pixels).
+ * @param card_height Height of a single card (in pixels).
+ * @return True if the file was written successfully.
+ */
+bool CardRenderer::write_sprite_sheet(std::string filename, int card_width,
+                                      int card_height) {
+  cairo_surface_t *sheet = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, 9 * card_width, 9 * card_height);
+  ++_frame_surface_allocations;
+  ++_total_surface_allocations;
+  cairo_t *cr = cairo_create(sheet);
+  for (unsigned char index = 0; index < CardIndex::CARDINDEX_COUNTER;
+       ++index) {
+    cairo_save(cr);
+    cairo_translate(cr, (index % 9) * card_width, (index / 9) * card_height);
+    draw_card(cr, Card::get_card(index), false, card_width, card_height);
+    cairo_restore(cr);
+  }
+  cairo_destroy(cr);
+  const cairo_status_t status =
+      cairo_surface_write_to_png(sheet, filename.c_str());
+  cairo_surface_destroy(sheet);
+  return status == CAIRO_STATUS_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * This file is part of OpenSet
+ * Copyright (C) 2017 Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ *
+ * OpenSet is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSet is distributed in the hope that it will be useful,
+ * but WITOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with OpenSet. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/**
+ * @file CardRenderer.hpp
+ *
+ * @brief Renderer that draws card faces using cairo.
+ *
+ * @author Bert Vandenbroucke (bert.vandenbroucke@gmail.com)
+ */
+
+#ifndef OPENSET_CARDRENDERER_HPP
+#define OPENSET_CARDRENDERER_HPP
+
+#include "../engine/CardProperties.hpp"
+
+#include <cairo.h>
+#include <string>
+
+class Card;
+
+/**
+ * @brief Renderer that draws card faces using cairo.
+ *
+ * The renderer only depends on cairo (and not on GTK), so that cards can be
+ * drawn to any cairo surface, including image surfaces on machines without a
+ * display.
+ *
+ * The renderer keeps a cache of the 9 fill patterns (one for every colour and
+ * fill type) that are used to fill the symbols on the cards, and a cache of
+ * the symbol outlines for the current card size. It counts the number of
+ * cairo surfaces, patterns and paths it allocates.
+ *
+ * Symbols that lie completely outside the clip region of the cairo context
+ * are not drawn, so that a partial repaint only pays for the symbols that
+ * actually change pixels.
+ */
+class CardRenderer {
+private:
+  /*! @brief Cache of fill patterns, for every colour and fill type (NULL if
+   *  the pattern has not been created yet). */
+  cairo_pattern_t *_fill_patterns[CardProperties::CARDCOLOUR_COUNTER]
+                                 [CardProperties::CARDFILL_COUNTER];
+
+  /*! @brief Cache of symbol outlines, centered on the origin (NULL if the
+   *  path has not been created yet). */
+  cairo_path_t *_symbol_paths[CardProperties::CARDSYMBOL_COUNTER];
+
+  /*! @brief Card width for which the cached symbol outlines were created. */
+  int _symbol_path_width;
+
+  /*! @brief Number of cairo surfaces allocated during the last frame. */
+  unsigned int _frame_surface_allocations;
+
+  /*! @brief Number of cairo patterns allocated during the last frame. */
+  unsigned int _frame_pattern_allocations;
+
+  /*! @brief Number of symbols drawn during the last frame. */
+  unsigned int _frame_shapes_drawn;
+
+  /*! @brief Number of symbols skipped during the last frame, because they
+   *  were completely outside the clip region. */
+  unsigned int _frame_shapes_skipped;
+
+  /*! @brief Total number of cairo surfaces allocated by this renderer. */
+  unsigned long _total_surface_allocations;
+
+  /*! @brief Total number of cairo patterns allocated by this renderer. */
+  unsigned long _total_pattern_allocations;
+
+  /*! @brief Total number of cairo paths allocated by this renderer. */
+  unsigned long _total_path_allocations;
+
+public:
+  CardRenderer();
+  ~CardRenderer();
+
+  // the pattern cache cannot be shared between renderers
+  CardRenderer(const CardRenderer &) = delete;
+  CardRenderer &operator=(const CardRenderer &) = delete;
+
+  void start_frame();
+  unsigned int get_frame_surface_allocations() const;
+  unsigned int get_frame_pattern_allocations() const;
+  unsigned int get_frame_shapes_drawn() const;
+  unsigned int get_frame_shapes_skipped() const;
+  unsigned long get_total_surface_allocations() const;
+  unsigned long get_total_pattern_allocations() const;
+  unsigned long get_total_path_allocations() const;
+
+  void draw_card(cairo_t *cr, const Card &card, bool clicked, int width,
+                 int height);
+  cairo_surface_t *create_card_surface(const Card &card, bool clicked,
+                                       int width, int height);
+  bool write_sprite_sheet(std::string filename, int card_width,
+                          int card_height);
+
+private:
+  static void draw_rounded_rectangle(cairo_t *cr, double origin_x,
+                                     double origin_y, double side_x,
+                                     double side_y, double r);
+  static void draw_oval(cairo_t *cr, double origin[2], double size[2]);
+  static void draw_rhombus(cairo_t *cr, double origin[2], double size[2]);
+  static void draw_wiggle(cairo_t *cr, double origin[2], double size[2]);
+  static void draw_shape(cairo_t *cr, CardProperties::CardSymbol shape,
+                         double origin[2], double size[2]);
+  static void set_drawing_colour(cairo_t *cr,
+                                 CardProperties::CardColour colour);
+
+  cairo_pattern_t *get_fill_pattern(CardProperties::CardColour colour,
+                                    CardProperties::CardFill fill);
+  void clear_fill_patterns();
+
+  const cairo_path_t *get_symbol_path(cairo_t *cr,
+                                      CardProperties::CardSymbol shape,
+                                      int width, double size[2]);
+  void clear_symbol_paths();
+};
+
+#endif // OPENSET_CARDRENDERER_HPP
@@ -28,6 +28,7 @@
 #include "../engine/Card.hpp"
 #include "../engine/CardManager.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 /**
@@ -67,10 +68,33 @@ unsigned char Window::CardExposeEvent::get_index() const { return _index; }
  * @param size_y Vertical initial size of the window (in pixels).
  * @param title Title for the window.
  * @param card_manager CardManager that contains information about the cards.
+ * The game runs on a separate engine thread, and the CardManager should not be
+ * accessed while the window exists.
  */
 Window::Window(int &argc, char **argv, unsigned int size_x, unsigned int size_y,
                std::string title, CardManager &card_manager)
-    : _card_manager(card_manager) {
+    : _notification_pending(false), _card_sizes{}, _card_faces{},
+      _card_face_sizes{}, _frame_painted_pixels(0),
+      _engine(card_manager, engine_notify, this) {
+  // the engine only changes the game when it receives a click, so we can
+  // still read the initial board
+  const GameState &state = card_manager.get_state();
+  _board._dirty = 0;
+  _board._clicked = state._clicked;
+  for (unsigned char i = 0; i < GameState::MAX_BOARD_SIZE; ++i) {
+    _board._main_deck[i] = state._main_deck[i];
+  }
+  _board._main_deck_size = state._main_deck_size;
+  _board._command_time = 0;
+
+  // the engine thread schedules callbacks on the GTK main thread, which
+  // requires thread support in older versions of GLib
+#if !GLIB_CHECK_VERSION(2, 32, 0)
+  if (!g_thread_supported()) {
+    g_thread_init(NULL);
+  }
+#endif
+
   // initialize GTK
   gtk_init(&argc, &argv);
 
@@ -118,6 +142,9 @@ Window::Window(int &argc, char **argv, unsigned int size_x, unsigned int size_y,
       g_signal_connect(_cards[3 * ix + iy], "button_press_event",
                        G_CALLBACK(card_click_event),
                        &_card_expose_events[3 * ix + iy]);
+      g_signal_connect(_cards[3 * ix + iy], "size-allocate",
+                       G_CALLBACK(card_size_allocate_event),
+                       &_card_expose_events[3 * ix + iy]);
 
       gtk_container_add(GTK_CONTAINER(_aspect_frames[3 * ix + iy]),
                         _cards[3 * ix + iy]);
@@ -126,11 +153,27 @@ Window::Window(int &argc, char **argv, unsigned int size_x, unsigned int size_y,
     }
   }
 
-  for (unsigned int i = 0; i < 12; ++i) {
+  // only show the slots that contain a card: the main deck can contain up to
+  // 18 cards if extra cards were dealt
+  for (unsigned char i = 0; i < _board._main_deck_size; ++i) {
     gtk_widget_show(_aspect_frames[i]);
   }
 }
 
+/**
+ * @brief Destructor.
+ *
+ * Stops the engine thread and frees the card face cache.
+ */
+Window::~Window() {
+  _engine.stop();
+  // the engine can no longer schedule new calls, remove the pending one
+  if (_notification_pending.load()) {
+    g_source_remove_by_user_data(this);
+  }
+  clear_card_faces();
+}
+
 /**
  * @brief Show the window and (optionally) enter the main GTK loop.
  *
@@ -155,201 +198,227 @@ void Window::show(bool start_application) {
 }
 
 /**
- * @brief Draw a rectangle with rounded edges.
- *
- * @param cr cairo_t instance to use for drawing.
- * @param origin_x Upper left corner of the rectangle: horizontal position.
- * @param origin_y Upper left corner of the rectangle: vertical position.
- * @param side_x Width: horizontal size of the rectangle.
- * @param side_y Height: vertical size of the rectangle.
- * @param r Radius used for round corners.
+ * @brief Get the number of cairo surfaces that were allocated while drawing
+ * the last card.
+ *
+ * @return Number of surface allocations during the last frame.
+ */
+unsigned int Window::get_frame_surface_allocations() const {
+  return _renderer.get_frame_surface_allocations();
+}
+
+/**
+ * @brief Get the number of cairo patterns that were allocated while drawing
+ * the last card.
+ *
+ * @return Number of pattern allocations during the last frame.
  */
-void Window::draw_rounded_rectangle(cairo_t *cr, double origin_x,
-                                    double origin_y, double side_x,
-                                    double side_y, double r) {
-
-  cairo_new_sub_path(cr);
-  cairo_arc(cr, origin_x + side_x - r, origin_y + r, r, -0.5 * M_PI, 0.);
-  cairo_arc(cr, origin_x + side_x - r, origin_y + side_y - r, r, 0.,
-            0.5 * M_PI);
-  cairo_arc(cr, origin_x + r, origin_y + side_y - r, r, 0.5 * M_PI, M_PI);
-  cairo_arc(cr, origin_x + r, origin_y + r, r, M_PI, 1.5 * M_PI);
-  cairo_close_path(cr);
+unsigned int Window::get_frame_pattern_allocations() const {
+  return _renderer.get_frame_pattern_allocations();
 }
 
 /**
- * @brief Draw an oval.
+ * @brief Get the number of pixels that were painted while drawing the last
+ * card.
+ *
+ * Partial exposes only repaint the exposed part of the card, so this number
+ * can be (much) smaller than the area of the card.
  *
- * @param cr cairo_t instance to use for drawing.
- * @param origin Coordinates of the center of the oval.
- * @param size Side lenghts of the oval.
+ * @return Number of pixels painted during the last frame.
  */
-void Window::draw_oval(cairo_t *cr, double origin[2], double size[2]) {
-  draw_rounded_rectangle(cr, origin[0] - 0.5 * size[0],
-                         origin[1] - 0.5 * size[1], size[0], size[1],
-                         0.5 * size[1]);
+unsigned int Window::get_frame_painted_pixels() const {
+  return _frame_painted_pixels;
 }
 
 /**
- * @brief Draw a rhombus.
+ * @brief Get the total number of cairo surfaces that were allocated.
  *
- * @param cr cairo_t instance to use for drawing.
- * @param origin Coordinates of the center of the rhombus.
- * @param size Side lengths of the rhombus.
+ * @return Total number of surface allocations.
  */
-void Window::draw_rhombus(cairo_t *cr, double origin[2], double size[2]) {
-  cairo_new_sub_path(cr);
-  cairo_move_to(cr, origin[0] - 0.5 * size[0], origin[1]);
-  cairo_line_to(cr, origin[0], origin[1] - 0.5 * size[1]);
-  cairo_line_to(cr, origin[0] + 0.5 * size[0], origin[1]);
-  cairo_line_to(cr, origin[0], origin[1] + 0.5 * size[1]);
-  cairo_line_to(cr, origin[0] - 0.5 * size[0], origin[1]);
-  cairo_close_path(cr);
+unsigned long Window::get_total_surface_allocations() const {
+  return _renderer.get_total_surface_allocations();
 }
 
 /**
- * @brief Draw a wiggly shape.
+ * @brief Get the total number of cairo patterns that were allocated.
  *
- * @param cr cairo_t instance to use for drawing.
- * @param origin Coordinates of the center of the wiggly shape.
- * @param size Side lenghts of the wiggly shape.
+ * @return Total number of pattern allocations.
  */
-void Window::draw_wiggle(cairo_t *cr, double origin[2], double size[2]) {
-  cairo_new_sub_path(cr);
-  cairo_move_to(cr, origin[0] - 0.5 * size[0], origin[1]);
-  cairo_curve_to(cr, origin[0] - 0.5 * size[0], origin[1] - 0.25 * size[1],
-                 origin[0] - 0.25 * size[0], origin[1] - 0.5 * size[1],
-                 origin[0], origin[1] - 0.25 * size[1]);
-  cairo_curve_to(cr, origin[0] + 0.25 * size[0], origin[1],
-                 origin[0] + 0.5 * size[0], origin[1] - 1. * size[1],
-                 origin[0] + 0.5 * size[0], origin[1]);
-  cairo_curve_to(cr, origin[0] + 0.5 * size[0], origin[1] + 0.25 * size[1],
-                 origin[0] + 0.25 * size[0], origin[1] + 0.5 * size[1],
-                 origin[0], origin[1] + 0.25 * size[1]);
-  cairo_curve_to(cr, origin[0] - 0.25 * size[0], origin[1],
-                 origin[0] - 0.5 * size[0], origin[1] + 1. * size[1],
-                 origin[0] - 0.5 * size[0], origin[1]);
-  cairo_close_path(cr);
+unsigned long Window::get_total_pattern_allocations() const {
+  return _renderer.get_total_pattern_allocations();
 }
 
 /**
- * @brief Draw the given shape.
+ * @brief Get the engine that runs the game.
  *
- * @param cr cairo_t instance to use for drawing.
- * @param shape CardSymbol to draw.
- * @param origin Coordinates of the center of the shape.
- * @param size Side lengths of the shape.
+ * The engine provides queue depth and latency metrics.
+ *
+ * @return Reference to the GameEngine.
+ */
+const GameEngine &Window::get_engine() const { return _engine; }
+
+/**
+ * @brief Apply all notifications sent by the engine.
+ *
+ * Only the cards that were changed are redrawn. Slots that received an extra
+ * card are shown, and slots that no longer contain a card (because the main
+ * deck shrunk) are hidden. Should be called by the GTK main thread.
  */
-void Window::draw_shape(cairo_t *cr, CardProperties::CardSymbol shape,
-                        double origin[2], double size[2]) {
-  switch (shape) {
-  case CardProperties::CARDSYMBOL_OVAL:
-    draw_oval(cr, origin, size);
-    break;
-  case CardProperties::CARDSYMBOL_RHOMBUS:
-    draw_rhombus(cr, origin, size);
-    break;
-  case CardProperties::CARDSYMBOL_WIGGLE:
-    draw_wiggle(cr, origin, size);
-    break;
+void Window::apply_notifications() {
+  // clear the flag first: notifications that arrive while we are busy
+  // schedule a new call
+  _notification_pending.store(false);
+  uint32_t dirty = 0;
+  while (_engine.pop_notification(_board)) {
+    dirty |= _board._dirty;
+  }
+  for (unsigned char i = 0; i < 18; ++i) {
+    if ((dirty >> i) & 1) {
+      if (i < _board._main_deck_size) {
+        gtk_widget_show(_aspect_frames[i]);
+        gtk_widget_queue_draw(_cards[i]);
+      } else {
+        gtk_widget_hide(_aspect_frames[i]);
+      }
+    }
   }
 }
 
 /**
- * @brief Set the drawing colour.
+ * @brief Get the rendered face of the given card.
+ *
+ * Card faces are rendered once into an image surface and are then reused,
+ * until the size of the card changes.
  *
- * @param cr cairo_t instance that will be affected.
- * @param colour CardColour to set.
+ * @param card Card.
+ * @param clicked Is the card clicked?
+ * @param width Width of the card (in pixels).
+ * @param height Height of the card (in pixels).
+ * @return Image surface containing the rendered card face. The surface is
+ * owned by the cache and should not be destroyed.
  */
-void Window::set_drawing_colour(cairo_t *cr,
-                                CardProperties::CardColour colour) {
-  switch (colour) {
-  case CardProperties::CARDCOLOUR_RED:
-    cairo_set_source_rgb(cr, 1, 0, 0);
-    break;
-  case CardProperties::CARDCOLOUR_BLUE:
-    cairo_set_source_rgb(cr, 0, 1, 0);
-    break;
-  case CardProperties::CARDCOLOUR_GREEN:
-    cairo_set_source_rgb(cr, 0, 0, 1);
-    break;
+cairo_surface_t *Window::get_card_face(const Card &card, bool clicked,
+                                       int width, int height) {
+  const unsigned char index = card.get_index();
+  cairo_surface_t *&face = _card_faces[index][clicked];
+  int *face_size = _card_face_sizes[index][clicked];
+  if (face == NULL || face_size[0] != width || face_size[1] != height) {
+    if (face != NULL) {
+      cairo_surface_destroy(face);
+    }
+    face = _renderer.create_card_surface(card, clicked, width, height);
+    face_size[0] = width;
+    face_size[1] = height;
+  }
+  return face;
+}
+
+/**
+ * @brief Clear the card face cache.
+ */
+void Window::clear_card_faces() {
+  for (unsigned char index = 0; index < CardIndex::CARDINDEX_COUNTER;
+       ++index) {
+    for (unsigned char clicked = 0; clicked < 2; ++clicked) {
+      if (_card_faces[index][clicked] != NULL) {
+        cairo_surface_destroy(_card_faces[index][clicked]);
+        _card_faces[index][clicked] = NULL;
+      }
+    }
   }
 }
 
 /**
  * @brief Draw the card with the given index.
  *
+ * The card face is taken from the card face cache, so that drawing a card
+ * that did not change is a single image copy that does not allocate any new
+ * cairo surfaces or patterns.
+ *
+ * If a region is given, only the part of the card inside that region is
+ * repainted.
+ *
  * @param index Index of a card in the card grid.
+ * @param region Region of the card that needs to be repainted (NULL to
+ * repaint the entire card).
  */
-void Window::draw_card(unsigned char index) {
+void Window::draw_card(unsigned char index, const GdkRegion *region) {
+  // every card is drawn in a separate expose event: a new frame starts
+  _renderer.start_frame();
+
   int width, height;
   width = _cards[index]->allocation.width;
   height = _cards[index]->allocation.height;
-  cairo_t *cr = gdk_cairo_create(gtk_widget_get_window(_cards[index]));
+  cairo_surface_t *face =
+      get_card_face(Card::get_card(_board._main_deck[index]),
+                    (_board._clicked >> index) & 1, width, height);
 
-  cairo_set_source_rgb(cr, 1, 1, 1);
-  draw_rounded_rectangle(cr, 0, 0, width, height, 20.);
-  cairo_fill(cr);
-
-  const Card &card = _card_manager.get_card(index);
-  if (card.is_clicked()) {
-    cairo_set_source_rgb(cr, 1, 0, 0);
-    draw_rounded_rectangle(cr, 0, 0, width, height, 20.);
-    cairo_stroke(cr);
-  }
-
-  double shape_size[2];
-  shape_size[0] = 0.5 * width;
-  shape_size[1] = 0.5 * shape_size[0];
-
-  double shape_origin[2];
-  shape_origin[0] = 0.5 * width;
-
-  int num_shape = card.get_number_of_symbols();
-  CardProperties::CardSymbol shape_type = card.get_symbol();
-  CardProperties::CardColour colour_type = card.get_colour();
-  int fill_type = 2 - static_cast<int>(card.get_fill());
-
-  cairo_surface_t *texture =
-      cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 10, 10);
-  cairo_t *tcr = cairo_create(texture);
-  set_drawing_colour(tcr, colour_type);
-  cairo_rectangle(tcr, fill_type * 5, 0, 10, 10);
-  cairo_fill(tcr);
-  cairo_destroy(tcr);
-  cairo_pattern_t *pattern = cairo_pattern_create_for_surface(texture);
-
-  double shape_spacing = height / (num_shape + 1.);
-  for (int i = 0; i < num_shape; ++i) {
-    shape_origin[1] = (i + 1) * shape_spacing;
-
-    draw_shape(cr, shape_type, shape_origin, shape_size);
-    cairo_set_source(cr, pattern);
-    cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_REPEAT);
-    cairo_fill_preserve(cr);
-    set_drawing_colour(cr, colour_type);
-    cairo_stroke(cr);
+  cairo_t *cr = gdk_cairo_create(gtk_widget_get_window(_cards[index]));
+  if (region != NULL) {
+    gdk_cairo_region(cr, region);
+    cairo_clip(cr);
+
+    // the rectangles of a region do not overlap, so the painted area is the
+    // sum of their areas (restricted to the card)
+    GdkRectangle *rectangles;
+    gint number_of_rectangles;
+    gdk_region_get_rectangles(region, &rectangles, &number_of_rectangles);
+    _frame_painted_pixels = 0;
+    for (gint i = 0; i < number_of_rectangles; ++i) {
+      const int x1 = std::max(rectangles[i].x, 0);
+      const int y1 = std::max(rectangles[i].y, 0);
+      const int x2 = std::min(rectangles[i].x + rectangles[i].width, width);
+      const int y2 = std::min(rectangles[i].y + rectangles[i].height, height);
+      if (x2 > x1 && y2 > y1) {
+        _frame_painted_pixels += (x2 - x1) * (y2 - y1);
+      }
+    }
+    g_free(rectangles);
+  } else {
+    _frame_painted_pixels = width * height;
   }
-
-  cairo_pattern_destroy(pattern);
-  cairo_surface_destroy(texture);
-
+  cairo_set_source_surface(cr, face, 0, 0);
+  cairo_paint(cr);
   cairo_destroy(cr);
 }
 
 /**
- * @brief Notify the CardManager that the card with the given index has been
- * clicked.
+ * @brief Send a click on the card with the given index to the engine.
+ *
+ * This does not wait for the engine: the cards are redrawn when the engine
+ * notifies us that the board changed (see apply_notifications()).
  *
- * Also forces a redraw of all cards.
+ * @param index Index of a card in the card grid.
  */
-void Window::card_clicked(unsigned char index) {
-  _card_manager.click_card(index);
-  for (unsigned char i = 0; i < 18; ++i) {
-    gtk_widget_queue_draw(_cards[i]);
+void Window::card_clicked(unsigned char index) { _engine.click_card(index); }
+
+/**
+ * @brief Function called by the engine thread when a notification is
+ * available.
+ *
+ * Schedules a call to apply_notifications() on the GTK main thread, unless a
+ * call is already pending.
+ *
+ * @param data Pointer to the Window instance.
+ */
+void Window::engine_notify(void *data) {
+  Window *window = static_cast<Window *>(data);
+  if (!window->_notification_pending.exchange(true)) {
+    g_idle_add(notification_idle, window);
   }
 }
 
+/**
+ * @brief Idle callback that applies the notifications sent by the engine.
+ *
+ * @param data Pointer to the Window instance.
+ * @return FALSE, so that the callback is only called once.
+ */
+gboolean Window::notification_idle(gpointer data) {
+  static_cast<Window *>(data)->apply_notifications();
+  return FALSE;
+}
+
 /**
  * @brief Event called when the window is closed by the user.
  *
@@ -375,7 +444,9 @@ void Window::delete_event(GtkWidget *widget, GdkEvent *event, gpointer data) {
 gboolean Window::card_expose_event(GtkWidget *widget, GdkEventExpose *event,
                                    gpointer data) {
   CardExposeEvent *card_expose_event = static_cast<CardExposeEvent *>(data);
-  card_expose_event->get_window()->draw_card(card_expose_event->get_index());
+  // only repaint the part of the card that was actually exposed
+  card_expose_event->get_window()->draw_card(card_expose_event->get_index(),
+                                             event->region);
   return FALSE;
 }
 
@@ -395,3 +466,27 @@ gboolean Window::card_click_event(GtkWidget *widget, GdkEvent *event,
   card_expose_event->get_window()->card_clicked(card_expose_event->get_index());
   return FALSE;
 }
+
+/**
+ * @brief Event triggered when a card is resized.
+ *
+ * If the size of the card changed, the cached card faces no longer have the
+ * right size and are cleared.
+ *
+ * @param widget Card that is resized.
+ * @param allocation New size of the card.
+ * @param data Extra data passed on to this event: a pointer to the Window
+ * instance and the index of the card that is resized.
+ */
+void Window::card_size_allocate_event(GtkWidget *widget,
+                                      GtkAllocation *allocation,
+                                      gpointer data) {
+  CardExposeEvent *card_expose_event = static_cast<CardExposeEvent *>(data);
+  Window *window = card_expose_event->get_window();
+  int *card_size = window->_card_sizes[card_expose_event->get_index()];
+  if (card_size[0] != allocation->width || card_size[1] != allocation->height) {
+    window->clear_card_faces();
+    card_size[0] = allocation->width;
+    card_size[1] = allocation->height;
+  }
+}
@@ -27,11 +27,15 @@
 #ifndef OPENSET_WINDOW_HPP
 #define OPENSET_WINDOW_HPP
 
-#include "../engine/CardProperties.hpp"
+#include "../engine/CardIndex.hpp"
+#include "../engine/GameEngine.hpp"
+#include "CardRenderer.hpp"
 
+#include <atomic>
 #include <gtk/gtk.h>
 #include <string>
 
+class Card;
 class CardManager;
 
 /**
@@ -69,38 +73,70 @@ private:
   /*! @brief Wrapped GTK drawing areas used to draw the actual cards. */
   GtkWidget *_cards[18];
 
-  /*! @brief CardManager that contains information about the cards. */
-  CardManager &_card_manager;
+  /*! @brief Board as it is currently shown: the last notification received
+   *  from the engine. */
+  EngineNotification _board;
+
+  /*! @brief Is a call to apply_notifications() scheduled? */
+  std::atomic<bool> _notification_pending;
 
   /*! @brief CardExposeEvents for the cards. */
   CardExposeEvent _card_expose_events[18];
 
+  /*! @brief Last allocated width and height of the drawing areas. */
+  int _card_sizes[18][2];
+
+  /*! @brief Cache of rendered card faces, for every card and both clicked
+   *  states (NULL if the face has not been rendered yet). */
+  cairo_surface_t *_card_faces[CardIndex::CARDINDEX_COUNTER][2];
+
+  /*! @brief Width and height of the cached card faces. */
+  int _card_face_sizes[CardIndex::CARDINDEX_COUNTER][2][2];
+
+  /*! @brief Renderer used to draw the card faces. */
+  CardRenderer _renderer;
+
+  /*! @brief Number of pixels that were painted while drawing the last card. */
+  unsigned int _frame_painted_pixels;
+
+  /*! @brief Engine that runs the game on its own thread. */
+  GameEngine _engine;
+
 public:
   Window(int &argc, char **argv, unsigned int size_x, unsigned int size_y,
          std::string title, CardManager &card_manager);
+  ~Window();
 
   void show(bool start_application = true);
 
+  unsigned int get_frame_surface_allocations() const;
+  unsigned int get_frame_pattern_allocations() const;
+  unsigned int get_frame_painted_pixels() const;
+  unsigned long get_total_surface_allocations() const;
+  unsigned long get_total_pattern_allocations() const;
+
+  const GameEngine &get_engine() const;
+  void apply_notifications();
+
 private:
-  static void draw_rounded_rectangle(cairo_t *cr, double origin_x,
-                                     double origin_y, double side_x,
-                                     double side_y, double r);
-  static void draw_oval(cairo_t *cr, double origin[2], double size[2]);
-  static void draw_rhombus(cairo_t *cr, double origin[2], double size[2]);
-  static void draw_wiggle(cairo_t *cr, double origin[2], double size[2]);
-  static void draw_shape(cairo_t *cr, CardProperties::CardSymbol shape,
-                         double origin[2], double size[2]);
-  static void set_drawing_colour(cairo_t *cr,
-                                 CardProperties::CardColour colour);
-
-  void draw_card(unsigned char index);
+  cairo_surface_t *get_card_face(const Card &card, bool clicked, int width,
+                                 int height);
+  void clear_card_faces();
+
+  void draw_card(unsigned char index, const GdkRegion *region = NULL);
   void card_clicked(unsigned char index);
 
+  static void engine_notify(void *data);
+  static gboolean notification_idle(gpointer data);
+
   static void delete_event(GtkWidget *widget, GdkEvent *event, gpointer data);
   static gboolean card_expose_event(GtkWidget *widget, GdkEventExpose *event,
                                     gpointer data);
   static gboolean card_click_event(GtkWidget *widget, GdkEvent *event,
                                    gpointer data);
+  static void card_size_allocate_event(GtkWidget *widget,
+                                       GtkAllocation *allocation,
+                                       gpointer data);
 };
 
 #endif // OPENSET_WINDOW_HPP